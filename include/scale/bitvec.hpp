@@ -6,8 +6,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
 #include <vector>
 
+#include <boost/endian/conversion.hpp>
+
+#include <scale/detail/simd.hpp>
+#include <scale/types.hpp>
+
 namespace scale {
   /**
    * @brief Bit vector encoding compatible with rust `BitVec<u8, Lsb0>`
@@ -19,4 +30,152 @@ namespace scale {
       return bits == other.bits;
     }
   };
+
+  /**
+   * @brief Bit vector encoding compatible with rust `BitVec<u8, Lsb0>`, the
+   * same as BitVec, but stored in 64-bit words: bit i is bit (i % 64) of word
+   * (i / 64). Bits are encoded and decoded by copying of whole bytes.
+   */
+  class PackedBitVec {
+   public:
+    using Word = uint64_t;
+    static constexpr size_t kWordBits = 64;
+
+    PackedBitVec() = default;
+
+    explicit PackedBitVec(size_t size, bool value = false)
+        : words_(wordsFor(size), value ? ~Word{0} : Word{0}), size_{size} {
+      clearTail();
+    }
+
+    explicit PackedBitVec(const std::vector<bool> &bits)
+        : PackedBitVec(bits.size()) {
+      for (size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i]) {
+          set(i);
+        }
+      }
+    }
+
+    explicit PackedBitVec(const BitVec &v) : PackedBitVec(v.bits) {}
+
+    size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    bool test(size_t i) const {
+      return ((words_[i / kWordBits] >> (i % kWordBits)) & 1) != 0;
+    }
+
+    void set(size_t i, bool value = true) {
+      const auto mask = Word{1} << (i % kWordBits);
+      auto &word = words_[i / kWordBits];
+      word = value ? (word | mask) : (word & ~mask);
+    }
+
+    /**
+     * @brief changes count of bits, new ones are unset
+     * @param size new count of bits
+     */
+    void resize(size_t size) {
+      words_.resize(wordsFor(size));
+      size_ = size;
+      clearTail();
+    }
+
+    /**
+     * @brief replaces content by bits packed into bytes in Lsb0 order, as they
+     * are encoded
+     * @param size count of bits
+     * @param bytes packed bits, at least (size + 7) / 8 bytes
+     */
+    void assign(size_t size, ConstSpanOfBytes bytes) {
+      const auto byte_count = size / 8 + (size % 8 != 0);
+      words_.resize(wordsFor(size));
+      size_ = size;
+      if (words_.empty()) {
+        return;
+      }
+      words_.back() = 0;
+      std::memcpy(words_.data(), bytes.data(), byte_count);
+      if constexpr (std::endian::native != std::endian::little) {
+        for (auto &word : words_) {
+          boost::endian::little_to_native_inplace(word);
+        }
+      }
+      clearTail();
+    }
+
+    /**
+     * @return count of set bits
+     */
+    size_t count() const {
+      return detail::countSetBits(words_);
+    }
+
+    PackedBitVec &operator&=(const PackedBitVec &other) {
+      const auto common = std::min(words_.size(), other.words_.size());
+      for (size_t i = 0; i < common; ++i) {
+        words_[i] &= other.words_[i];
+      }
+      std::fill(words_.begin() + common, words_.end(), Word{0});
+      return *this;
+    }
+
+    PackedBitVec &operator|=(const PackedBitVec &other) {
+      const auto common = std::min(words_.size(), other.words_.size());
+      for (size_t i = 0; i < common; ++i) {
+        words_[i] |= other.words_[i];
+      }
+      clearTail();
+      return *this;
+    }
+
+    friend PackedBitVec operator&(PackedBitVec lhs, const PackedBitVec &rhs) {
+      return lhs &= rhs;
+    }
+
+    friend PackedBitVec operator|(PackedBitVec lhs, const PackedBitVec &rhs) {
+      return lhs |= rhs;
+    }
+
+    std::vector<bool> toBits() const {
+      std::vector<bool> bits(size_);
+      for (size_t i = 0; i < size_; ++i) {
+        bits[i] = test(i);
+      }
+      return bits;
+    }
+
+    BitVec toBitVec() const {
+      return BitVec{toBits()};
+    }
+
+    /**
+     * @return words of bits, bits after size() are unset
+     */
+    std::span<const Word> words() const {
+      return words_;
+    }
+
+    bool operator==(const PackedBitVec &other) const = default;
+
+   private:
+    static size_t wordsFor(size_t size) {
+      return size / kWordBits + (size % kWordBits != 0);
+    }
+
+    void clearTail() {
+      if (size_ % kWordBits != 0) {
+        words_.back() &= (Word{1} << (size_ % kWordBits)) - 1;
+      }
+    }
+
+    std::vector<Word> words_;
+    size_t size_ = 0;
+  };
 }  // namespace scale
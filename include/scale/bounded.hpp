@@ -0,0 +1,70 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace scale {
+
+  /**
+   * @brief Vector compatible with rust `BoundedVec<T, ConstU32<Max>>`:
+   * encoded as std::vector, but decoding of more than Max items fails with
+   * TOO_MANY_ITEMS right after length, before any allocation, and encoding of
+   * them fails with EncodeError::TOO_MANY_ITEMS
+   * @tparam T type of item
+   * @tparam Max max count of items
+   */
+  template <typename T, size_t Max>
+  struct BoundedVec : std::vector<T> {
+    using Base = std::vector<T>;
+    using Base::Base;
+
+    /// max count of items
+    static constexpr size_t kMaxSize = Max;
+
+    BoundedVec() = default;
+    explicit BoundedVec(Base items) : Base(std::move(items)) {}
+
+    static constexpr size_t max_size() {
+      return Max;
+    }
+  };
+
+  /**
+   * @brief String with limited length: encoded as std::string, but decoding
+   * of more than Max bytes fails with TOO_MANY_ITEMS right after length,
+   * before any allocation, and encoding of them fails with
+   * EncodeError::TOO_MANY_ITEMS
+   * @tparam Max max count of bytes
+   */
+  template <size_t Max>
+  struct BoundedString : std::string {
+    using std::string::string;
+
+    /// max count of bytes
+    static constexpr size_t kMaxSize = Max;
+
+    BoundedString() = default;
+    explicit BoundedString(std::string str) : std::string(std::move(str)) {}
+
+    static constexpr size_t max_size() {
+      return Max;
+    }
+  };
+
+  /// @brief Concept of collection with limited count of items
+  template <typename T>
+  concept BoundedCollection = requires {
+    { std::remove_cvref_t<T>::kMaxSize } -> std::convertible_to<size_t>;
+  };
+
+}  // namespace scale
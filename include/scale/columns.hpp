@@ -0,0 +1,264 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <scale/detail/aggregate.hpp>
+#include <scale/memcpy_codable.hpp>
+#include <scale/types.hpp>
+
+namespace scale {
+
+  template <typename... T>
+  class ColumnsView;
+
+  namespace detail {
+
+    template <typename Fields>
+    struct columns_of;
+
+    /// @brief std::tuple of vectors of each type
+    template <typename... F>
+    struct columns_of<std::tuple<F...>> {
+      using type = std::tuple<std::vector<F>...>;
+      static constexpr bool fixed_width = (MemcpyCodable<F> and ...);
+
+      static auto view(const type &columns) {
+        return std::apply(
+            [](const auto &...column) {
+              return ColumnsView<F...>{std::span(column)...};
+            },
+            columns);
+      }
+    };
+
+    /**
+     * @return total size of first types of tuple
+     */
+    template <typename Fields, size_t... I>
+    constexpr size_t sizeOfFields(std::index_sequence<I...>) {
+      return (sizeof(std::tuple_element_t<I, Fields>) + ... + 0);
+    }
+
+  }  // namespace detail
+
+  /**
+   * @brief Read-only view over equally sized columns, encoded as vector of
+   * rows, i.e. the same as std::vector<std::tuple<T...>> or vector of
+   * aggregates of the same fields. If all columns are memcpy-codable, rows
+   * are transposed from columns directly while encoding.
+   * @tparam T types of items of columns
+   */
+  template <typename... T>
+  class ColumnsView {
+   public:
+    static_assert(sizeof...(T) != 0, "Row must have fields");
+
+    /// true if each row is encoded by fixed count of bytes
+    static constexpr bool kFixedWidth = (MemcpyCodable<T> and ...);
+
+    /// size of encoded row of fixed width
+    static constexpr size_t kRowSize = (sizeof(T) + ...);
+
+    explicit ColumnsView(std::span<const T>... columns)
+        : columns_{columns...} {}
+
+    /**
+     * @return count of rows
+     */
+    size_t size() const {
+      return std::get<0>(columns_).size();
+    }
+
+    /**
+     * @return true if all columns have the same size
+     */
+    bool consistent() const {
+      return std::apply(
+          [&](const auto &...columns) {
+            return ((columns.size() == size()) and ...);
+          },
+          columns_);
+    }
+
+    /**
+     * @return column of I-th field of all rows
+     */
+    template <size_t I>
+    auto column() const {
+      return std::get<I>(columns_);
+    }
+
+    /**
+     * @brief writes encoded rows by strided copies of columns
+     * @param first index of first row
+     * @param count count of rows
+     * @param out buffer of count * kRowSize bytes
+     */
+    void writeRows(size_t first, size_t count, uint8_t *out) const
+      requires kFixedWidth
+    {
+      [&]<size_t... I>(std::index_sequence<I...>) {
+        (writeColumn<I>(first, count, out), ...);
+      }(std::make_index_sequence<sizeof...(T)>{});
+    }
+
+   private:
+    template <size_t I>
+    void writeColumn(size_t first, size_t count, uint8_t *out) const {
+      using Item = std::tuple_element_t<I, std::tuple<T...>>;
+      out += detail::sizeOfFields<std::tuple<T...>>(
+          std::make_index_sequence<I>{});
+      for (const auto &item : column<I>().subspan(first, count)) {
+        std::memcpy(out, &item, sizeof(Item));
+        out += kRowSize;
+      }
+    }
+
+    std::tuple<std::span<const T>...> columns_;
+  };
+
+  template <typename... R>
+  ColumnsView(const R &...) -> ColumnsView<std::ranges::range_value_t<R>...>;
+
+  /**
+   * @brief Struct-of-arrays representation of sequence of aggregates: each
+   * field is stored in its own contiguous column. Encoded the same as
+   * std::vector<A>. If all fields are memcpy-codable, records have fixed
+   * size and columns are decoded and encoded by strided copies.
+   * @tparam A aggregate type of record
+   */
+  template <SimpleCodeableAggregate A>
+  class Columns {
+   public:
+    using Record = A;
+    using Fields = detail::aggregate_fields_t<A>;
+
+    static constexpr size_t kFieldCount = std::tuple_size_v<Fields>;
+    static_assert(kFieldCount != 0, "Record must have fields");
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, Fields>;
+
+    /// true if each record is encoded by fixed count of bytes
+    static constexpr bool kFixedWidth = detail::columns_of<Fields>::fixed_width;
+
+    Columns() = default;
+
+    /**
+     * @return count of records
+     */
+    size_t size() const {
+      return std::get<0>(columns_).size();
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    /**
+     * @return column of I-th field of all records
+     */
+    template <size_t I>
+    std::vector<Field<I>> &column() {
+      return std::get<I>(columns_);
+    }
+
+    template <size_t I>
+    const std::vector<Field<I>> &column() const {
+      return std::get<I>(columns_);
+    }
+
+    /**
+     * @param i index of record
+     * @return record assembled from fields
+     */
+    A operator[](size_t i) const {
+      return std::apply(
+          [i](const auto &...columns) { return A{columns[i]...}; }, columns_);
+    }
+
+    void push_back(const A &record) {
+      detail::decompose_and_apply(record, [&](const auto &...fields) {
+        std::apply(
+            [&](auto &...columns) { (columns.push_back(fields), ...); },
+            columns_);
+      });
+    }
+
+    void resize(size_t count) {
+      std::apply([count](auto &...columns) { (columns.resize(count), ...); },
+                 columns_);
+    }
+
+    void reserve(size_t count) {
+      std::apply([count](auto &...columns) { (columns.reserve(count), ...); },
+                 columns_);
+    }
+
+    void clear() {
+      std::apply([](auto &...columns) { (columns.clear(), ...); }, columns_);
+    }
+
+    /**
+     * @return offset of I-th field within encoded record
+     */
+    template <size_t I>
+    static constexpr size_t fieldOffset() {
+      return detail::sizeOfFields<Fields>(std::make_index_sequence<I>{});
+    }
+
+    /// size of encoded record of fixed width
+    static constexpr size_t kRecordSize = fieldOffset<kFieldCount>();
+
+    /**
+     * @brief fills columns from encoded records by strided copies, count of
+     * records is already set by resize()
+     * @param records encoded records
+     */
+    void assignRecords(ConstSpanOfBytes records)
+      requires kFixedWidth
+    {
+      [&]<size_t... I>(std::index_sequence<I...>) {
+        (assignColumn<I>(records), ...);
+      }(std::make_index_sequence<kFieldCount>{});
+    }
+
+    /**
+     * @return view over columns, which is encoded the same
+     */
+    auto view() const
+      requires kFixedWidth
+    {
+      return detail::columns_of<Fields>::view(columns_);
+    }
+
+    bool operator==(const Columns &other) const = default;
+
+   private:
+    template <size_t I>
+    void assignColumn(ConstSpanOfBytes records) {
+      const auto *in = records.data() + fieldOffset<I>();
+      for (auto &item : column<I>()) {
+        std::memcpy(&item, in, sizeof(Field<I>));
+        in += kRecordSize;
+      }
+    }
+
+    typename detail::columns_of<Fields>::type columns_;
+  };
+
+}  // namespace scale
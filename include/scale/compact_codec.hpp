@@ -0,0 +1,79 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <scale/detail/compact_integer.hpp>
+#include <scale/detail/jam_compact_integer.hpp>
+#include <scale/types.hpp>
+
+namespace scale {
+
+  /**
+   * @brief Compact integer codec of SCALE specification.
+   * Policy of BasicScaleEncoderStream and BasicScaleDecoderStream
+   */
+  struct ScaleCompactCodec {
+    /// bits of first byte, all unset if value is encoded by one byte
+    static constexpr uint8_t kMultiByteBits = 0b00000011u;
+    /// shift of value within one-byte encoding
+    static constexpr uint8_t kSingleByteShift = 2;
+
+    static size_t lengthOf(CompactCompatible auto value) {
+      return detail::lengthOfEncodedCompactInteger(value);
+    }
+
+    static size_t write(uint64_t value, uint8_t *out) {
+      return detail::writeNativeCompactInteger(value, out);
+    }
+
+    template <typename T>
+    static void encode(T &&value, EncoderStream auto &stream) {
+      detail::encodeCompactInteger(std::forward<T>(value), stream);
+    }
+
+    template <typename T>
+      requires CompactCompatible<T>
+    static T decode(DecoderStream auto &stream) {
+      return detail::decodeCompactInteger<T>(stream);
+    }
+  };
+
+  /**
+   * @brief Compact integer codec of JAM specification.
+   * Policy of BasicScaleEncoderStream and BasicScaleDecoderStream
+   */
+  struct JamCompactCodec {
+    /// bits of first byte, all unset if value is encoded by one byte
+    static constexpr uint8_t kMultiByteBits = 0b10000000u;
+    /// shift of value within one-byte encoding
+    static constexpr uint8_t kSingleByteShift = 0;
+
+    static size_t lengthOf(CompactCompatible auto value) {
+      return detail::lengthOfEncodedJamCompactInteger(value);
+    }
+
+    static size_t write(uint64_t value, uint8_t *out) {
+      return detail::writeNativeJamCompactInteger(value, out);
+    }
+
+    template <typename T>
+    static void encode(T &&value, EncoderStream auto &stream) {
+      detail::encodeJamCompactInteger(std::forward<T>(value), stream);
+    }
+
+    template <typename T>
+      requires CompactCompatible<T>
+    static T decode(DecoderStream auto &stream) {
+      return detail::decodeJamCompactInteger<T>(stream);
+    }
+  };
+
+}  // namespace scale
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
+#include <boost/endian/conversion.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <scale/detail/fixed_width_integer.hpp>
@@ -28,17 +32,56 @@ namespace scale::detail {
 
   /// Returns the compact encoded length for the given value.
   size_t lengthOfEncodedCompactInteger(CompactCompatible auto val) {
-    if (val < kMinUint16) return 1;
-    if (val < kMinUint32) return 2;
-    if (val < kMinBigInteger) return 4;
     if constexpr (std::unsigned_integral<decltype(val)>) {
-      return 1 + std::bit_width(val);
+      // branchless, so it can be vectorized over a range of values
+      const auto bits = static_cast<size_t>(std::bit_width(val));
+      return val < kMinBigInteger ? size_t{1} << ((bits > 6u) + (bits > 14u))
+                                  : 1 + (bits + 7) / 8;
     } else {
+      if (val < kMinUint16) return 1;
+      if (val < kMinUint32) return 2;
+      if (val < kMinBigInteger) return 4;
       // number of bytes required to represent value
-      return 1 + msb(val) / 8;
+      return 1 + (msb(val) / 8 + 1);
     }
   }
 
+  /**
+   * Writes native integer in compact-integer representation by single store
+   * @param value integer value
+   * @param out destination, must have room for kMaxNativeCompactSize bytes
+   * @return count of bytes of encoded value
+   */
+  inline size_t writeNativeCompactInteger(uint64_t value, uint8_t *out) {
+    if (value < kMinBigInteger) {
+      // Mode 0b00, 0b01 or 0b10 means 1, 2 or 4 bytes respectively
+      const auto bits = std::bit_width(value);
+      const uint32_t mode = (bits > 6u) + (bits > 14u);
+      boost::endian::store_little_u32(
+          out, (static_cast<uint32_t>(value) << 2u) | mode);
+      return size_t{1} << mode;
+    }
+    // See the header layout description in encodeCompactInteger
+    const size_t significant_bytes_n = (std::bit_width(value) + 7) / 8;
+    out[0] = ((significant_bytes_n - 4) << 2u) | 0b11;
+    boost::endian::store_little_u64(out + 1, value);
+    return 1 + significant_bytes_n;
+  }
+
+  /**
+   * Encodes native integer to compact-integer representation, and writes it
+   * to stream by single store
+   * @tparam S output stream type
+   * @param value integer value
+   */
+  template <typename S>
+    requires EncoderStream<S>
+  void encodeNativeCompactInteger(uint64_t value, S &stream) {
+    std::array<uint8_t, kMaxNativeCompactSize> bytes;
+    auto size = writeNativeCompactInteger(value, bytes.data());
+    stream.putBytes({bytes.data(), size});
+  }
+
   /**
    * Encodes any integer type to compact-integer representation
    * @tparam T integer type
@@ -47,84 +90,61 @@ namespace scale::detail {
    * @return byte array representation of value as compact-integer
    */
   template <typename T, typename S>
-    requires CompactCompatible<std::remove_cvref_t<T>>
-             and std::derived_from<std::remove_cvref_t<S>, ScaleEncoderStream>
+    requires CompactCompatible<std::remove_cvref_t<T>> and EncoderStream<S>
   void encodeCompactInteger(T &&value, S &stream) {
-    constexpr auto is_integral = std::unsigned_integral<std::remove_cvref_t<T>>;
-
-    // cannot encode negative numbers
-    // there is no description how to encode compact negative numbers
-    if (value < 0) {
-      raise(EncodeError::NEGATIVE_COMPACT_INTEGER);
-    }
-
-    if (value < kMinUint16) {
-      uint8_t v;
-      if constexpr (is_integral) {
-        v = (static_cast<uint8_t>(value) << 2u) | 0b00;
-      } else {
-        v = (value.template convert_to<uint8_t>() << 2u) | 0b00;
+    if constexpr (std::unsigned_integral<std::remove_cvref_t<T>>) {
+      static_assert(sizeof(T) <= sizeof(uint64_t));
+      return encodeNativeCompactInteger(value, stream);
+    } else {
+      // cannot encode negative numbers
+      // there is no description how to encode compact negative numbers
+      if (value < 0) {
+        raise(EncodeError::NEGATIVE_COMPACT_INTEGER);
       }
-      return encodeInteger(v, stream);
-    }
 
-    if (value < kMinUint32) {
-      // only values from [kMinUint16, kMinUint32) can be put here
-      uint16_t v;
-      if constexpr (is_integral) {
-        v = (static_cast<uint16_t>(value) << 2u) | 0b01;
-      } else {
-        v = (value.template convert_to<uint16_t>() << 2u) | 0b01;
+      // multiprecision is used only if value does not fit native integer
+      if (value.is_zero() or msb(value) < 64) {
+        return encodeNativeCompactInteger(value.template convert_to<uint64_t>(),
+                                          stream);
       }
-      return encodeInteger(v, stream);
-    }
 
-    if (value < kMinBigInteger) {
-      // only values from [kMinUint32, kMinBigInteger) can be put here
-      uint32_t v;
-      if constexpr (is_integral) {
-        v = (static_cast<uint32_t>(value) << 2u) | 0b10;
-      } else {
-        v = (value.template convert_to<uint32_t>() << 2u) | 0b10;
-      }
-      return encodeInteger(v, stream);
-    }
-
-    size_t significant_bytes_n;
-    if constexpr (is_integral) {
-      significant_bytes_n = std::bit_width(value);
-    } else {
       // number of bytes required to represent value
-      significant_bytes_n = msb(value) / 8 + 1;
+      size_t significant_bytes_n = msb(value) / 8 + 1;
 
       if (significant_bytes_n > 67) {
         raise(EncodeError::COMPACT_INTEGER_TOO_BIG);
       }
-    }
 
-    // The upper 6 bits of the header are used to encode the number of bytes
-    // required to store the big integer. The value stored in these 6 bits
-    // ranges from 0 to 63 (2^6 - 1). However, the actual byte count starts
-    // from 4, so we subtract 4 from the byte count before encoding it.
-    // This makes the range of byte counts for storing big integers 4 to 67.
-    // To construct the final header, the upper 6 bits are shifted left by
-    // 2 positions (equivalent to multiplying by 4).
-    // The lower 2 bits (minor bits) store the encoding option, which in this
-    // case is 0b11 (decimal value 3). The final header is formed by adding 3
-    // to the result of the previous operations.
-    uint8_t header = ((significant_bytes_n - 4) << 2u) | 0b11;
-
-    stream << header;
-
-    for (auto v = value; v != 0; v >>= 8) {
-      // push back the least significant byte
-      stream << static_cast<uint8_t>(v & 0xff);
+      // The upper 6 bits of the header are used to encode the number of bytes
+      // required to store the big integer. The value stored in these 6 bits
+      // ranges from 0 to 63 (2^6 - 1). However, the actual byte count starts
+      // from 4, so we subtract 4 from the byte count before encoding it.
+      // This makes the range of byte counts for storing big integers 4 to 67.
+      // To construct the final header, the upper 6 bits are shifted left by
+      // 2 positions (equivalent to multiplying by 4).
+      // The lower 2 bits (minor bits) store the encoding option, which in this
+      // case is 0b11 (decimal value 3). The final header is formed by adding 3
+      // to the result of the previous operations.
+      std::array<uint8_t, 68> bytes;
+      bytes[0] = ((significant_bytes_n - 4) << 2u) | 0b11;
+
+      // push back bytes starting from the least significant one
+      export_bits(value, bytes.begin() + 1, 8, false);
+
+      stream.putBytes({bytes.data(), 1 + significant_bytes_n});
     }
   }
 
-  template <typename S>
-    requires std::derived_from<std::remove_cvref_t<S>, ScaleDecoderStream>
-  boost::multiprecision::uint1024_t decodeCompactInteger(S &stream) {
+  /**
+   * Decodes any integer type from compact-integer representation
+   * @tparam T integer type
+   * @tparam S input stream type
+   * @param stream input stream
+   * @return value according compact-integer representation
+   */
+  template <typename T, typename S>
+    requires CompactCompatible<T> and DecoderStream<S>
+  T decodeCompactInteger(S &stream) {
     auto first_byte = stream.nextByte();
 
     const uint8_t flag = first_byte & 0b00000011u;
@@ -150,19 +170,13 @@ namespace scale::detail {
       }
 
       case 0b10u: {
-        number = first_byte;
-        size_t multiplier = 256u;
-        if (not stream.hasMore(3u)) {
-          raise(DecodeError::NOT_ENOUGH_DATA);
-        }
+        auto bytes = stream.nextBytes(3u);
 
-        for (auto i = 0u; i < 3u; ++i) {
-          // we assured that there are 3 more bytes,
-          // no need to make checks in a loop
-          number += stream.nextByte() * multiplier;
-          multiplier <<= 8u;
-        }
-        number = number >> 2u;
+        number = (static_cast<size_t>(first_byte)
+                  | (static_cast<size_t>(bytes[0]) << 8u)
+                  | (static_cast<size_t>(bytes[1]) << 16u)
+                  | (static_cast<size_t>(bytes[2]) << 24u))
+                 >> 2u;
         if ((number >> 14) == 0) {
           raise(DecodeError::REDUNDANT_COMPACT_ENCODING);
         }
@@ -171,52 +185,47 @@ namespace scale::detail {
 
       case 0b11: {
         auto bytes_count = ((first_byte) >> 2u) + 4u;
-        if (not stream.hasMore(bytes_count)) {
-          raise(DecodeError::NOT_ENOUGH_DATA);
-        }
+        auto bytes = stream.nextBytes(bytes_count);
 
-        boost::multiprecision::uint1024_t multiplier{1u};
-        boost::multiprecision::uint1024_t value{0};
-        // we assured that there are m more bytes,
-        // no need to make checks in a loop
-        for (auto i = 0u; i < bytes_count; ++i) {
-          value += stream.nextByte() * multiplier;
-          multiplier <<= 8u;
-        }
-        if (value.is_zero()) {
+        // Canonical encoding has non-zero most significant byte, and value
+        // which can not be encoded by 4-bytes mode (i.e. less than 2^30)
+        if (bytes.back() == 0
+            or (bytes_count == 4 and bytes.back() < 0b01000000u)) {
           raise(DecodeError::REDUNDANT_COMPACT_ENCODING);
         }
-        auto bits = msb(value) + 1;
-        if (bits <= 30 or (bits + 7) / 8 < bytes_count) {
-          raise(DecodeError::REDUNDANT_COMPACT_ENCODING);
+
+        // Most significant byte is not zero, so value occupies all the bytes
+        if (bytes_count * 8 > std::numeric_limits<T>::digits) {
+          raise(DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+        }
+
+        if constexpr (std::unsigned_integral<T>) {
+          uint64_t value = 0;
+          std::memcpy(&value, bytes.data(), bytes_count);
+          return static_cast<T>(boost::endian::little_to_native(value));
+        } else {
+          T value;
+          import_bits(value, bytes.begin(), bytes.end(), 8, false);
+          return value;
         }
-        return value;  // special case
       }
 
       default:
         UNREACHABLE
     }
 
-    return number;
+    if constexpr (std::numeric_limits<T>::digits < 30) {
+      if (number > std::numeric_limits<T>::max()) {
+        raise(DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+      }
+    }
+    return static_cast<T>(number);
   }
 
-  /**
-   * Decodes any integer type from compact-integer representation
-   * @tparam T integer type
-   * @tparam S input stream type
-   * @param value integer value
-   * @return value according compact-integer representation
-   */
-  template <typename T, typename S>
-    requires std::unsigned_integral<T>
-             and std::derived_from<std::remove_cvref_t<S>, ScaleDecoderStream>
-  T decodeCompactInteger(S &stream) {
-    auto integer = decodeCompactInteger(stream);
-    if (not integer.is_zero()
-        and msb(integer) >= std::numeric_limits<T>::digits) {
-      raise(DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
-    }
-    return static_cast<T>(integer);
+  template <typename S>
+    requires DecoderStream<S>
+  boost::multiprecision::uint1024_t decodeCompactInteger(S &stream) {
+    return decodeCompactInteger<boost::multiprecision::uint1024_t>(stream);
   }
 
 }  // namespace scale::detail
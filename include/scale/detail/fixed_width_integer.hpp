@@ -13,11 +13,6 @@
 
 #include <scale/types.hpp>
 
-namespace scale {
-  class ScaleEncoderStream;
-  class ScaleDecoderStream;
-}  // namespace scale
-
 namespace scale {
 
   /**
@@ -110,20 +105,19 @@ namespace scale {
   /**
    * @brief Encodes an integer to little-endian representation.
    * @tparam T Integer type.
+   * @tparam S Type of the SCALE encoder stream.
    * @param value Integer value to encode.
    * @param stream Output stream where encoded data is written.
    */
-  template <typename T>
-    requires std::is_integral_v<std::remove_cvref_t<T>>
-  void encodeInteger(T value, ScaleEncoderStream &stream) {
+  template <typename T, typename S>
+    requires std::is_integral_v<std::remove_cvref_t<T>> and EncoderStream<S>
+  void encodeInteger(T value, S &stream) {
     using I = std::remove_cvref_t<T>;
     constexpr size_t size = sizeof(I);
     constexpr size_t bits = size * 8;
     boost::endian::endian_buffer<boost::endian::order::little, I, bits> buf{};
     buf = value;  // Assign value to endian buffer
-    for (size_t i = 0; i < size; ++i) {
-      stream << buf.data()[i];  // Write each byte to the stream
-    }
+    stream.putBytes({buf.data(), size});  // Write all bytes to the stream
   }
 
   /**
@@ -133,7 +127,7 @@ namespace scale {
    * @param s Encoder stream.
    */
   template <typename S>
-    requires std::derived_from<std::remove_cvref_t<S>, ScaleEncoderStream>
+    requires EncoderStream<S>
   void encodeInteger(const BigFixedWidthInteger auto &v, S &s) {
     using Integer = std::remove_cvref_t<decltype(v)>;
     static constexpr auto bits = FixedWidthIntegerTraits<Integer>::bits;
@@ -145,12 +139,13 @@ namespace scale {
   /**
    * @brief Decodes an integer from little-endian representation.
    * @tparam T Integer type.
+   * @tparam S Type of the SCALE decoder stream.
    * @param value Reference to store the decoded integer.
    * @param stream Input stream from which data is read.
    */
-  template <typename T>
-    requires std::is_integral_v<std::remove_cvref_t<T>>
-  void decodeInteger(T &value, ScaleDecoderStream &stream) {
+  template <typename T, typename S>
+    requires std::is_integral_v<std::remove_cvref_t<T>> and DecoderStream<S>
+  void decodeInteger(T &value, S &stream) {
     using I = std::remove_cvref_t<T>;
     constexpr size_t size = sizeof(I);
     constexpr size_t bits = size * 8;
@@ -168,7 +163,7 @@ namespace scale {
    * @param s Decoder stream.
    */
   template <typename S>
-    requires std::derived_from<std::remove_cvref_t<S>, ScaleDecoderStream>
+    requires DecoderStream<S>
   void decodeInteger(BigFixedWidthInteger auto &v, S &s) {
     using Integer = std::remove_cvref_t<decltype(v)>;
     static constexpr auto bits = FixedWidthIntegerTraits<Integer>::bits;
@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+
+#include <boost/endian/conversion.hpp>
 
 #include <scale/outcome/outcome_throw.hpp>
 #include <scale/scale_error.hpp>
@@ -17,15 +22,58 @@
 
 namespace scale::detail {
 
+  /// Returns count of bytes following the prefix in jam-compact encoding.
+  /// Each of them adds 7 bits of capacity, up to the whole 8-bytes tail.
+  constexpr size_t lengthOfJamCompactTail(uint64_t value) {
+    const auto bits = std::max<size_t>(std::bit_width(value), 1);
+    return std::min<size_t>((bits - 1) / 7, sizeof(uint64_t));
+  }
+
   /// Returns the compact encoded length for the given value.
   size_t lengthOfEncodedJamCompactInteger(CompactCompatible auto value) {
     if constexpr (std::unsigned_integral<decltype(value)>) {
-      return 1 + (std::bit_width(value) - 1) / 7;
+      return 1 + lengthOfJamCompactTail(value);
     } else {
-      return 1 + msb(value - 1) / 7;
+      const size_t bits = value.is_zero() ? 1 : msb(value) + 1;
+      return 1 + std::min<size_t>((bits - 1) / 7, sizeof(uint64_t));
     }
   }
 
+  /**
+   * Writes native integer in jam-compact-integer representation by single
+   * store
+   * @param value integer value
+   * @param out destination, must have room for kMaxNativeCompactSize bytes
+   * @return count of bytes of encoded value
+   */
+  inline size_t writeNativeJamCompactInteger(uint64_t value, uint8_t *out) {
+    const auto len = lengthOfJamCompactTail(value);
+
+    // Leading ones of prefix are count of following bytes,
+    // the rest of prefix keeps the most significant bits of value
+    const uint8_t len_bits = ~(0xFFu >> len);
+    const uint8_t val_bits =
+        len < sizeof(uint64_t) ? static_cast<uint8_t>(value >> (8 * len)) : 0;
+
+    out[0] = len_bits | val_bits;
+    boost::endian::store_little_u64(out + 1, value);
+    return 1 + len;
+  }
+
+  /**
+   * Encodes native integer to jam-compact-integer representation, and writes
+   * it to stream by single store
+   * @tparam S output stream type
+   * @param value integer value
+   */
+  template <typename S>
+    requires EncoderStream<S>
+  void encodeNativeJamCompactInteger(uint64_t value, S &stream) {
+    std::array<uint8_t, kMaxNativeCompactSize> bytes;
+    auto size = writeNativeJamCompactInteger(value, bytes.data());
+    stream.putBytes({bytes.data(), size});
+  }
+
   /**
    * Encodes any integer type to jam-compact-integer representation
    * @tparam T integer type
@@ -34,15 +82,11 @@ namespace scale::detail {
    * @return byte array representation of value as jam-compact-integer
    */
   template <typename T, typename S>
-    requires CompactCompatible<std::remove_cvref_t<T>>
-             and std::derived_from<std::remove_cvref_t<S>, ScaleEncoderStream>
+    requires CompactCompatible<std::remove_cvref_t<T>> and EncoderStream<S>
   void encodeJamCompactInteger(T &&integer, S &stream) {
-    constexpr auto is_integral = std::unsigned_integral<std::remove_cvref_t<T>>;
-
-    size_t value;
-
-    if constexpr (is_integral) {
-      value = static_cast<size_t>(integer);
+    if constexpr (std::unsigned_integral<std::remove_cvref_t<T>>) {
+      static_assert(sizeof(T) <= sizeof(uint64_t));
+      return encodeNativeJamCompactInteger(integer, stream);
     } else {
       // cannot encode negative numbers
       // there is no description how to encode compact negative numbers
@@ -50,82 +94,74 @@ namespace scale::detail {
         raise(EncodeError::NEGATIVE_COMPACT_INTEGER);
       }
       if (integer.is_zero()) {
-        value = 0;
-      } else {
-        if (msb(integer) >= std::numeric_limits<size_t>::digits) {
-          raise(EncodeError::VALUE_TOO_BIG_FOR_COMPACT_REPRESENTATION);
-        }
-        value = integer.template convert_to<size_t>();
+        return encodeNativeJamCompactInteger(0, stream);
       }
+      if (msb(integer) >= std::numeric_limits<uint64_t>::digits) {
+        raise(EncodeError::VALUE_TOO_BIG_FOR_COMPACT_REPRESENTATION);
+      }
+      encodeNativeJamCompactInteger(integer.template convert_to<uint64_t>(),
+                                    stream);
     }
+  }
 
-    if (value < 0x80) {
-      stream << static_cast<uint8_t>(value);
-      return;
+  /**
+   * Decodes native integer from jam-compact-integer representation
+   * @tparam S input stream type
+   * @param stream input stream
+   * @return value according jam-compact-integer representation
+   */
+  template <typename S>
+    requires DecoderStream<S>
+  uint64_t decodeJamCompactInteger(S &stream) {
+    const uint8_t prefix = stream.nextByte();
+    const auto len = static_cast<size_t>(std::countl_one(prefix));
+
+    auto bytes = stream.nextBytes(len);
+
+    uint64_t value;
+    const auto data = stream.span();
+    const auto tail_offset = static_cast<size_t>(bytes.data() - data.data());
+    if (data.size() - tail_offset >= sizeof(uint64_t)) {
+      // Load the whole word at once and mask off bytes beyond the tail
+      const uint64_t mask = len < sizeof(uint64_t)
+                              ? (uint64_t{1} << (8 * len)) - 1
+                              : ~uint64_t{0};
+      value = boost::endian::load_little_u64(bytes.data()) & mask;
+    } else {
+      value = 0;
+      std::memcpy(&value, bytes.data(), len);
+      value = boost::endian::little_to_native(value);
     }
 
-    std::array<uint8_t, sizeof(size_t) + 1> bytes;
-    uint8_t &prefix = bytes[0] = 0;
-    size_t len = 1;
-
-    for (decltype(value) i = value; i != 0; i >>= 8) {
-      // minimal value in prefix
-      if (i <= (static_cast<uint8_t>(~prefix) >> 1)) {
-        prefix |= i;
-        break;
-      }
-      prefix = (prefix >> 1) | 0x80;
-      bytes[len++] = static_cast<uint8_t>(i & 0xff);
+    if (len < sizeof(uint64_t)) {
+      value |= static_cast<uint64_t>(prefix & (0x7Fu >> len)) << (8 * len);
     }
 
-    for (auto byte : bytes) {
-      stream << byte;
-      if (--len == 0) break;
+    // Canonical encoding has the shortest tail able to keep the value
+    if (len != 0 and value < (uint64_t{1} << (7 * len))) {
+      raise(DecodeError::REDUNDANT_COMPACT_ENCODING);
     }
+    return value;
   }
 
   /**
    * Decodes any integer type from jam-compact-integer representation
    * @tparam T integer type
    * @tparam S input stream type
-   * @param value integer value
+   * @param stream input stream
    * @return value according jam-compact-integer representation
    */
-  template <typename S>
-    requires std::derived_from<std::remove_cvref_t<S>, ScaleDecoderStream>
-  boost::multiprecision::uint128_t decodeJamCompactInteger(S &stream) {
-    uint8_t byte;
-
-    stream >> byte;
-
-    if (byte == 0) {
-      return 0;
-    }
-
-    uint8_t len_bits = byte;
-    uint8_t val_bits = byte;
-    uint8_t val_mask = 0xff;
-
-    size_t value = 0;
-
-    for (uint8_t i = 0; i < 8; ++i) {
-      val_mask >>= 1;
-      val_bits &= val_mask;
-
-      if ((len_bits & static_cast<uint8_t>(0x80))
-          == 0) {  // no more significant bytes
-        value |= static_cast<size_t>(val_bits) << (8 * i);
-        break;
+  template <typename T, typename S>
+    requires CompactCompatible<T> and DecoderStream<S>
+  T decodeJamCompactInteger(S &stream) {
+    const auto value = decodeJamCompactInteger(stream);
+    if constexpr (std::numeric_limits<T>::digits
+                  < std::numeric_limits<uint64_t>::digits) {
+      if (value > std::numeric_limits<T>::max()) {
+        raise(DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
       }
-      len_bits <<= 1;
-
-      stream >> byte;
-      value |= static_cast<size_t>(byte) << (8 * i);
     }
-    if (val_bits == 0 and (byte & ~val_mask) == 0) {
-      raise(DecodeError::REDUNDANT_COMPACT_ENCODING);
-    }
-    return value;
+    return static_cast<T>(value);
   }
 
 }  // namespace scale::detail
@@ -0,0 +1,111 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace scale::detail {
+
+  template <typename K>
+  struct is_byte_array : std::false_type {};
+
+  template <size_t N>
+  struct is_byte_array<std::array<uint8_t, N>> : std::true_type {};
+
+  /**
+   * @brief Concept of key, whose order by operator< is the order of its
+   * digits (bytes), so collection can be sorted by radix sort
+   */
+  template <typename K>
+  concept RadixSortableKey = (std::integral<K> and not std::same_as<K, bool>)
+                          or is_byte_array<K>::value;
+
+  /**
+   * @return count of digits of key, i.e. passes of radix sort
+   */
+  template <RadixSortableKey K>
+  constexpr size_t radixDigitsOf() {
+    if constexpr (std::integral<K>) {
+      return sizeof(K);
+    } else {
+      return std::tuple_size_v<K>;
+    }
+  }
+
+  /**
+   * @param key key to get digit of
+   * @param i index of digit, from the least significant
+   * @return i-th digit of key
+   */
+  template <RadixSortableKey K>
+  uint8_t radixDigit(const K &key, size_t i) {
+    if constexpr (std::integral<K>) {
+      using U = std::make_unsigned_t<K>;
+      auto value = static_cast<U>(key);
+      if constexpr (std::is_signed_v<K>) {
+        // negative values go first
+        value ^= U{1} << (sizeof(U) * 8 - 1);
+      }
+      return static_cast<uint8_t>(value >> (i * 8));
+    } else {
+      return key[key.size() - 1 - i];
+    }
+  }
+
+  /**
+   * Sorts items by key in ascending order. Items are referenced by pointers,
+   * so they are not copied. Integer and byte array keys are sorted by LSD
+   * radix sort, passes where all items have the same digit are skipped.
+   * Other keys are compared by operator<.
+   * @param items pointers to items to sort
+   * @param buffer scratch buffer, reused across calls to avoid allocations
+   * @param key_of function returning key of item by its pointer
+   */
+  template <typename KeyOf>
+  void sortByKey(std::vector<const void *> &items,
+                 std::vector<const void *> &buffer,
+                 const KeyOf &key_of) {
+    using Key = std::remove_cvref_t<decltype(key_of(items.front()))>;
+    // comparison sort is faster for short collections
+    constexpr size_t kMinRadixSortSize = 64;
+
+    if constexpr (RadixSortableKey<Key>) {
+      if (items.size() >= kMinRadixSortSize) {
+        buffer.resize(items.size());
+        for (size_t digit = 0; digit < radixDigitsOf<Key>(); ++digit) {
+          std::array<size_t, 256> offsets{};
+          for (auto item : items) {
+            ++offsets[radixDigit(key_of(item), digit)];
+          }
+          if (std::ranges::find(offsets, items.size()) != offsets.end()) {
+            continue;
+          }
+          size_t offset = 0;
+          for (auto &count : offsets) {
+            offset += std::exchange(count, offset);
+          }
+          for (auto item : items) {
+            buffer[offsets[radixDigit(key_of(item), digit)]++] = item;
+          }
+          items.swap(buffer);
+        }
+        return;
+      }
+    }
+    std::ranges::sort(items, [&](const void *lhs, const void *rhs) {
+      return key_of(lhs) < key_of(rhs);
+    });
+  }
+
+}  // namespace scale::detail
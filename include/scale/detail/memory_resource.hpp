@@ -0,0 +1,71 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+#include <scale/detail/aggregate.hpp>
+#include <scale/memcpy_codable.hpp>
+#include <scale/types.hpp>
+
+namespace scale::detail {
+
+  template <typename T>
+  struct is_optional : std::false_type {};
+
+  template <typename T>
+  struct is_optional<std::optional<T>> : std::true_type {};
+
+  template <typename T>
+  constexpr bool usesMemoryResource();
+
+  template <typename... F>
+  constexpr bool fieldsUseMemoryResource(std::type_identity<std::tuple<F...>>) {
+    return (usesMemoryResource<std::remove_cv_t<F>>() or ...);
+  }
+
+  /**
+   * @return true for aggregate, whose fields allocate by polymorphic
+   * allocator, so it is constructed from fields decoded by memory resource
+   * @tparam T type of value
+   */
+  template <typename T>
+  constexpr bool aggregateUsesMemoryResource() {
+    if constexpr (SimpleCodeableAggregate<T> and not MemcpyCodable<T>) {
+      return fieldsUseMemoryResource(
+          std::type_identity<aggregate_fields_t<T>>{});
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @return true for type allocating by polymorphic allocator (e.g. std::pmr
+   * containers), and for aggregates, pairs, tuples and optionals of them
+   * @tparam T type of value
+   */
+  template <typename T>
+  constexpr bool usesMemoryResource() {
+    if constexpr (is_pair_or_tuple<T>::value) {
+      return fieldsUseMemoryResource(
+          std::type_identity<typename fields_of<T>::type>{});
+    } else if constexpr (is_optional<T>::value) {
+      return usesMemoryResource<typename T::value_type>();
+    } else if constexpr (std::uses_allocator_v<
+                             T,
+                             std::pmr::polymorphic_allocator<>>) {
+      return true;
+    } else {
+      return aggregateUsesMemoryResource<T>();
+    }
+  }
+
+}  // namespace scale::detail
@@ -0,0 +1,107 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <scale/types.hpp>
+
+/**
+ * @brief Vectorized kernels of bulk encoding and decoding.
+ * Implementation is selected at runtime: AVX2, SSE2 or POPCNT on x86-64
+ * when available, and scalar fallback otherwise.
+ */
+namespace scale::detail {
+
+  /**
+   * Returns count of leading bytes having none of given bits set
+   * @param bytes bytes to scan
+   * @param bits mask of bits which must be unset
+   * @return length of the longest prefix of such bytes
+   */
+  size_t countLeadingBytesWithClearBits(ConstSpanOfBytes bytes, uint8_t bits);
+
+  /**
+   * Checks that bytes are well-formed UTF-8 (RFC 3629): no overlong forms,
+   * no surrogates, no code points above U+10FFFF, no truncated sequences
+   * @param bytes bytes to check
+   * @return true if bytes are valid UTF-8
+   */
+  bool isValidUtf8(ConstSpanOfBytes bytes);
+
+  /**
+   * Returns count of set bits in words
+   * @param words words to count bits of
+   * @return total count of set bits
+   */
+  size_t countSetBits(std::span<const uint64_t> words);
+
+  /**
+   * Expands bits of byte, from the least significant one, into 8 bytes of 0
+   * or 1 by few word operations
+   * @param bits byte of bits
+   * @param bytes destination of 8 bytes
+   */
+  inline void expandBitsToBytes(uint8_t bits, uint8_t *bytes) {
+    // byte i of replicated value keeps bit i only, then it is moved to bit 0
+    uint64_t word = (bits * 0x0101010101010101ull) & 0x8040201008040201ull;
+    word = ((word + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+    boost::endian::store_little_u64(bytes, word);
+  }
+
+  /**
+   * Packs up to 8 bytes of 0 or 1 into bits of byte, from the least
+   * significant one, by few word operations
+   * @param bytes bytes of 0 or 1, those after the 8th are ignored
+   * @return byte of bits, missing bytes give unset bits
+   */
+  inline uint8_t packBytesToBits(ConstSpanOfBytes bytes) {
+    uint64_t word = 0;
+    if (bytes.size() >= 8) {
+      word = boost::endian::load_little_u64(bytes.data());
+    } else {
+      for (size_t i = 0; i < bytes.size(); ++i) {
+        word |= uint64_t{bytes[i]} << (i * 8);
+      }
+    }
+    // moves byte i to bit 56 + i, partial products do not overlap
+    return static_cast<uint8_t>((word * 0x0102040810204080ull) >> 56);
+  }
+
+  /// @brief implementation of kernel for particular instruction set
+  template <typename Fn>
+  struct SimdImpl {
+    const char *isa;
+    Fn *fn;
+  };
+
+  using CountLeadingBytesWithClearBitsFn = size_t(const uint8_t *data,
+                                                  size_t size,
+                                                  uint8_t bits);
+  using IsValidUtf8Fn = bool(const uint8_t *data, size_t size);
+  using CountSetBitsFn = size_t(const uint64_t *words, size_t size);
+
+  /**
+   * Implementations of kernel for each instruction set supported by CPU,
+   * from scalar one to the one selected at runtime (the last), so each of
+   * them can be tested on any host
+   */
+  std::vector<SimdImpl<CountLeadingBytesWithClearBitsFn>>
+  countLeadingBytesWithClearBitsImpls();
+
+  /// @see countLeadingBytesWithClearBitsImpls
+  std::vector<SimdImpl<IsValidUtf8Fn>> isValidUtf8Impls();
+
+  /// @see countLeadingBytesWithClearBitsImpls
+  std::vector<SimdImpl<CountSetBitsFn>> countSetBitsImpls();
+
+}  // namespace scale::detail
@@ -18,8 +18,9 @@ namespace scale {
   struct EncodeOpaqueValue {
     ConstSpanOfBytes v;
 
-    friend ScaleEncoderStream &operator<<(ScaleEncoderStream &s,
-                                          const EncodeOpaqueValue &value) {
+    template <typename C>
+    friend BasicScaleEncoderStream<C> &operator<<(
+        BasicScaleEncoderStream<C> &s, const EncodeOpaqueValue &value) {
       for (auto &item : value.v) {
         s << item;
       }
@@ -38,11 +39,13 @@ namespace scale {
    * self_encoded = scale::encode(vec);
    * @endcode
    * but the actual implementation is a bit more optimal
+   * @tparam CompactCodec codec of compact integers of vector length
    * @param self_encoded - An encoded vector of EncodeOpaqueValue
    * @param input - A vector encoded as an EncodeOpaqueValue and added to
    * \param self_encoded
    * @return success if input was appended to self_encoded, failure otherwise
    */
+  template <typename CompactCodec = DefaultCompactCodec>
   outcome::result<void> append_or_new_vec(std::vector<uint8_t> &self_encoded,
                                           ConstSpanOfBytes input);
 }  // namespace scale
@@ -11,11 +11,10 @@
 
 #include <scale/outcome/outcome_throw.hpp>
 #include <scale/scale_error.hpp>
+#include <scale/types.hpp>
 
 namespace scale {
 
-  class ScaleDecoderStream;
-
   /**
    * Description of an enum type
    * Two specialization choices:
@@ -80,13 +79,18 @@ namespace scale {
 
   /**
    * @brief scale-decodes any enum type as underlying type
+   * @tparam C compact integer codec of stream
    * @tparam T enum type
    * @param v value of enum type
    * @return reference to stream
    */
-  template <typename T>
+  template <typename C, typename T>
     requires std::is_enum_v<std::remove_cvref_t<T>>
-  ScaleDecoderStream &operator>>(ScaleDecoderStream &s, T &v) {
+  BasicScaleDecoderStream<C> &operator>>(BasicScaleDecoderStream<C> &s,
+                                         T &v) {
+    static_assert(detail::decoder_fits_codec<C, T>,
+                  "operator>> of enum is written for ScaleDecoderStream only, "
+                  "make it template of BasicScaleDecoderStream<C>");
     using E = std::decay_t<T>;
     std::underlying_type_t<E> value;
     s >> value;
@@ -0,0 +1,137 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <scale/memcpy_codable.hpp>
+#include <scale/types.hpp>
+
+namespace scale {
+
+  /**
+   * @brief Sequence of sequences of memcpy-codable items (e.g. rust
+   * `Vec<Vec<u8>>`), stored in compressed form: items of all inner sequences
+   * are in one contiguous buffer and inner sequences are delimited by offsets.
+   * Encoded the same as std::vector<std::vector<T>>, but decoded with two
+   * allocations in total instead of one per inner sequence.
+   * @tparam T type of item
+   */
+  template <MemcpyCodable T>
+  class FlatNested {
+   public:
+    FlatNested() = default;
+    FlatNested(const FlatNested &) = default;
+    FlatNested &operator=(const FlatNested &) = default;
+
+    /// moved-from object is left empty, with the leading offset in place
+    FlatNested(FlatNested &&other)
+        : values_{std::move(other.values_)},
+          offsets_{std::move(other.offsets_)} {
+      other.clear();
+    }
+
+    FlatNested &operator=(FlatNested &&other) {
+      if (this != &other) {
+        values_ = std::move(other.values_);
+        offsets_ = std::move(other.offsets_);
+        other.clear();
+      }
+      return *this;
+    }
+
+    /**
+     * @return count of inner sequences
+     */
+    size_t size() const {
+      return offsets_.size() - 1;
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    /**
+     * @param i index of inner sequence
+     * @return items of i-th inner sequence
+     */
+    std::span<const T> operator[](size_t i) const {
+      return std::span(values_).subspan(offsets_[i],
+                                        offsets_[i + 1] - offsets_[i]);
+    }
+
+    /**
+     * @return range of spans of items of inner sequences
+     */
+    auto spans() const {
+      return std::views::iota(size_t{0}, size())
+           | std::views::transform([this](size_t i) { return (*this)[i]; });
+    }
+
+    /**
+     * @return items of all inner sequences one after another
+     */
+    std::span<const T> values() const {
+      return values_;
+    }
+
+    /**
+     * @return offsets of inner sequences in values(), starting by 0 and
+     * ending by total count of items
+     */
+    std::span<const size_t> offsets() const {
+      return offsets_;
+    }
+
+    void clear() {
+      values_.clear();
+      offsets_.assign(1, 0);
+    }
+
+    /**
+     * @brief reserves room for inner sequences and their items
+     * @param count count of inner sequences
+     * @param total_items total count of items of all inner sequences
+     */
+    void reserve(size_t count, size_t total_items) {
+      offsets_.reserve(count + 1);
+      values_.reserve(total_items);
+    }
+
+    /**
+     * @brief appends inner sequence
+     * @param items items of new inner sequence
+     */
+    void push_back(std::span<const T> items) {
+      values_.insert(values_.end(), items.begin(), items.end());
+      offsets_.push_back(values_.size());
+    }
+
+    /**
+     * @brief appends inner sequence of items encoded by bytes
+     * @param bytes encoded items, size is multiple of item size
+     */
+    void pushBackEncoded(ConstSpanOfBytes bytes) {
+      using Iterator = detail::UnalignedIterator<T>;
+      values_.insert(values_.end(),
+                     Iterator{bytes.data()},
+                     Iterator{bytes.data() + bytes.size()});
+      offsets_.push_back(values_.size());
+    }
+
+    bool operator==(const FlatNested &other) const = default;
+
+   private:
+    std::vector<T> values_;
+    std::vector<size_t> offsets_{0};
+  };
+
+}  // namespace scale
@@ -0,0 +1,261 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+
+#include <qtils/tagged.hpp>
+
+#include <scale/detail/aggregate.hpp>
+#include <scale/types.hpp>
+
+namespace scale {
+
+  /**
+   * Trait of types whose SCALE encoding is exactly their object
+   * representation, so contiguous collections of them are encoded and decoded
+   * by a single copy of memory.
+   * True for fixed-width integers (except bool, whose decoding validates
+   * value) on little-endian hosts, for arrays of such types, and for
+   * padding-free aggregates of such fields, unless aggregate has own encoding
+   * or decoding operator.
+   * @note specialize as std::true_type to opt in own trivially copyable type
+   * @tparam T type of item
+   */
+  template <typename T>
+  struct is_memcpy_codable : std::false_type {};
+
+  template <std::integral T>
+    requires(not std::same_as<T, bool>)
+  struct is_memcpy_codable<T>
+      : std::bool_constant<sizeof(T) == 1
+                           or std::endian::native == std::endian::little> {};
+
+  template <typename T, size_t N>
+  struct is_memcpy_codable<std::array<T, N>>
+      : std::bool_constant<is_memcpy_codable<T>::value
+                           and sizeof(std::array<T, N>) == sizeof(T) * N> {};
+
+  template <typename T, size_t N>
+  struct is_memcpy_codable<T[N]> : is_memcpy_codable<T> {};
+
+  template <typename T>
+  constexpr bool is_memcpy_codable_v =
+      is_memcpy_codable<std::remove_cvref_t<T>>::value;
+
+  /// @brief Concept of type which is scale-encoded as its own memory
+  template <typename T>
+  concept MemcpyCodable =
+      is_memcpy_codable_v<T>
+      and std::is_trivially_copyable_v<std::remove_cvref_t<T>>;
+
+  namespace detail {
+
+    /**
+     * Checks that all fields of aggregate are memcpy-codable and occupy whole
+     * object, i.e. there is no padding between and after them, so object
+     * memory is the same as concatenation of encoded fields.
+     * @note aggregates with bit-fields must not be used
+     * @tparam T aggregate type
+     */
+    template <typename T>
+    constexpr bool is_padding_free_aggregate() {
+      using Result = decltype(decompose_and_apply(
+          std::declval<T &>(), [](const auto &...fields) {
+            return std::bool_constant<(MemcpyCodable<decltype(fields)> and ...)
+                                      and (sizeof(fields) + ... + 0)
+                                              == sizeof(T)>{};
+          }));
+      return Result::value;
+    }
+
+  }  // namespace detail
+
+  template <typename T>
+    requires SimpleCodeableAggregate<T> and (not qtils::is_tagged_v<T>)
+             and std::is_trivially_copyable_v<T>
+             and std::is_standard_layout_v<T> and (not HasCustomCodec<T>)
+  struct is_memcpy_codable<T>
+      : std::bool_constant<detail::is_padding_free_aggregate<T>()> {};
+
+  /// @brief Concept of contiguous range of memcpy-codable items
+  template <typename R>
+  concept MemcpyCodableRange =
+      std::ranges::contiguous_range<R> and std::ranges::sized_range<R>
+      and MemcpyCodable<std::ranges::range_value_t<R>>;
+
+  /**
+   * @brief Concept of contiguous range of bool. Object representation of
+   * such range is its encoding, but decoded bytes must be validated first.
+   */
+  template <typename R>
+  concept BoolContiguousRange =
+      std::ranges::contiguous_range<R> and std::ranges::sized_range<R>
+      and std::same_as<std::ranges::range_value_t<R>, bool>
+      and sizeof(bool) == 1;
+
+  namespace detail {
+
+    /**
+     * @brief object representation of all items of range
+     * @param range contiguous range of memcpy-codable items
+     * @return span of bytes
+     */
+    ConstSpanOfBytes asBytes(const MemcpyCodableRange auto &range) {
+      using Item = std::ranges::range_value_t<decltype(range)>;
+      return {reinterpret_cast<const uint8_t *>(std::ranges::data(range)),
+              std::ranges::size(range) * sizeof(Item)};
+    }
+
+    /**
+     * @brief object representation of all bools of range, each is 0 or 1
+     * @param range contiguous range of bool
+     * @return span of bytes
+     */
+    ConstSpanOfBytes asBytes(const BoolContiguousRange auto &range) {
+      return {reinterpret_cast<const uint8_t *>(std::ranges::data(range)),
+              std::ranges::size(range)};
+    }
+
+    /**
+     * Random access iterator over items laid out in bytes with no alignment,
+     * each item is loaded by memcpy on dereference. Allows to fill container
+     * by assign() at once, without zero-initialization by resize() before.
+     * @tparam T memcpy-codable item type
+     */
+    template <typename T>
+    class UnalignedIterator {
+     public:
+      using iterator_category = std::random_access_iterator_tag;
+      using iterator_concept = std::random_access_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = T;
+
+      UnalignedIterator() = default;
+      explicit UnalignedIterator(const uint8_t *ptr) : ptr_{ptr} {}
+
+      T operator*() const {
+        T item;
+        std::memcpy(&item, ptr_, sizeof(T));
+        return item;
+      }
+      T operator[](difference_type n) const {
+        return *(*this + n);
+      }
+
+      UnalignedIterator &operator++() {
+        ptr_ += sizeof(T);
+        return *this;
+      }
+      UnalignedIterator operator++(int) {
+        auto it = *this;
+        ++*this;
+        return it;
+      }
+      UnalignedIterator &operator--() {
+        ptr_ -= sizeof(T);
+        return *this;
+      }
+      UnalignedIterator operator--(int) {
+        auto it = *this;
+        --*this;
+        return it;
+      }
+      UnalignedIterator &operator+=(difference_type n) {
+        ptr_ += n * static_cast<difference_type>(sizeof(T));
+        return *this;
+      }
+      UnalignedIterator &operator-=(difference_type n) {
+        return *this += -n;
+      }
+
+      friend UnalignedIterator operator+(UnalignedIterator it,
+                                         difference_type n) {
+        return it += n;
+      }
+      friend UnalignedIterator operator+(difference_type n,
+                                         UnalignedIterator it) {
+        return it += n;
+      }
+      friend UnalignedIterator operator-(UnalignedIterator it,
+                                         difference_type n) {
+        return it -= n;
+      }
+      friend difference_type operator-(const UnalignedIterator &lhs,
+                                       const UnalignedIterator &rhs) {
+        return (lhs.ptr_ - rhs.ptr_) / static_cast<difference_type>(sizeof(T));
+      }
+
+      bool operator==(const UnalignedIterator &) const = default;
+      auto operator<=>(const UnalignedIterator &) const = default;
+
+     private:
+      const uint8_t *ptr_ = nullptr;
+    };
+
+    /**
+     * @brief fills contiguous collection by memcpy-codable items copied from
+     * bytes at once, avoiding initialization of memory before copying where
+     * container allows it
+     * @param collection collection to fill
+     * @param bytes encoded items
+     */
+    template <typename C>
+    void assignFromBytes(C &collection, ConstSpanOfBytes bytes) {
+      using Item = std::ranges::range_value_t<C>;
+      using Iterator = UnalignedIterator<Item>;
+      const size_t count = bytes.size() / sizeof(Item);
+      constexpr auto copy_to = [](Item *out, ConstSpanOfBytes from) {
+        if (not from.empty()) {
+          std::memcpy(out, from.data(), from.size());
+        }
+      };
+
+      if constexpr (requires {
+                      collection.resize_and_overwrite(
+                          count, [](Item *, size_t n) { return n; });
+                    }) {
+        collection.resize_and_overwrite(count, [&](Item *out, size_t n) {
+          copy_to(out, bytes);
+          return n;
+        });
+      } else if constexpr (sizeof(Item) == 1 and std::integral<Item>
+                           and requires(const Item *p) {
+                             collection.assign(p, p);
+                           }) {
+        // bytes may be accessed as any character type
+        auto *items = reinterpret_cast<const Item *>(bytes.data());
+        collection.assign(items, items + count);
+      } else if constexpr (InlineCapacityCollection<C>) {
+        // storage is mostly inline, so initialization of items by resize()
+        // costs less, than copying them one by one
+        collection.resize(count);
+        copy_to(std::ranges::data(collection), bytes);
+      } else if constexpr (requires {
+                             collection.assign(Iterator{}, Iterator{});
+                           }) {
+        collection.assign(Iterator{bytes.data()},
+                          Iterator{bytes.data() + bytes.size()});
+      } else {
+        collection.resize(count);
+        copy_to(std::ranges::data(collection), bytes);
+      }
+    }
+
+  }  // namespace detail
+
+}  // namespace scale
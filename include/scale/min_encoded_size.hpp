@@ -0,0 +1,109 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <qtils/tagged.hpp>
+
+#include <scale/detail/aggregate.hpp>
+#include <scale/types.hpp>
+
+namespace scale {
+
+  /**
+   * Trait of the least count of bytes any value of type is encoded by, so
+   * decoder could reject count of items, which remaining data can not hold,
+   * before allocating room for them.
+   * Zero means the size is unknown, so no such check is possible. It is so
+   * for types with own encoding or decoding operator, since their encoding
+   * is not deduced from the type structure, and for enums, since their
+   * templated codecs can not be detected.
+   * @note specialize for own type, if it has own codec
+   * @tparam T type of value
+   */
+  template <typename T>
+  struct min_encoded_size : std::integral_constant<size_t, 0> {};
+
+  template <typename T>
+  constexpr size_t min_encoded_size_v =
+      min_encoded_size<std::remove_cvref_t<T>>::value;
+
+  template <std::integral T>
+  struct min_encoded_size<T> : std::integral_constant<size_t, sizeof(T)> {};
+
+  // compact integers and length prefixes take one byte at least
+  template <CompactInteger T>
+  struct min_encoded_size<T> : std::integral_constant<size_t, 1> {};
+
+  template <DynamicCollection T>
+    requires(not qtils::is_tagged_v<T>)
+  struct min_encoded_size<T> : std::integral_constant<size_t, 1> {};
+
+  template <typename T>
+  struct min_encoded_size<std::optional<T>>
+      : std::integral_constant<size_t, 1> {};
+
+  template <typename T, size_t N>
+  struct min_encoded_size<std::array<T, N>>
+      : std::integral_constant<size_t, N * min_encoded_size_v<T>> {};
+
+  template <typename T, size_t N>
+  struct min_encoded_size<T[N]>
+      : std::integral_constant<size_t, N * min_encoded_size_v<T>> {};
+
+  template <typename F, typename S>
+  struct min_encoded_size<std::pair<F, S>>
+      : std::integral_constant<size_t,
+                               min_encoded_size_v<F> + min_encoded_size_v<S>> {
+  };
+
+  template <typename... T>
+  struct min_encoded_size<std::tuple<T...>>
+      : std::integral_constant<size_t, (min_encoded_size_v<T> + ... + 0)> {};
+
+  // index byte and the shortest alternative
+  template <typename... T>
+  struct min_encoded_size<std::variant<T...>>
+      : std::integral_constant<size_t,
+                               1 + std::min({min_encoded_size_v<T>...})> {};
+
+  namespace detail {
+
+    /**
+     * @return total least size of encoded fields of aggregate
+     * @tparam T aggregate or custom decomposable type
+     */
+    template <typename T>
+    constexpr size_t minEncodedSizeOfFields() {
+      using Result = decltype(decompose_and_apply(
+          std::declval<T &>(), [](const auto &...fields) {
+            return std::integral_constant<
+                size_t,
+                (min_encoded_size_v<decltype(fields)> + ... + 0)>{};
+          }));
+      return Result::value;
+    }
+
+  }  // namespace detail
+
+  template <typename T>
+    requires(SimpleCodeableAggregate<T> or CustomDecomposable<T>)
+            and (not qtils::is_tagged_v<T>) and (not HasCustomCodec<T>)
+  struct min_encoded_size<T>
+      : std::integral_constant<size_t, detail::minEncodedSizeOfFields<T>()> {
+  };
+
+}  // namespace scale
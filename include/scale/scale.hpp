@@ -10,6 +10,7 @@
 #include <boost/throw_exception.hpp>
 
 #include <qtils/outcome.hpp>
+#include <scale/bounded.hpp>
 #include <scale/configurable.hpp>
 #include <scale/definitions.hpp>
 #include <scale/enum_traits.hpp>
@@ -43,36 +44,50 @@ namespace scale {
     OUTCOME_TRY(encode(s, std::forward<T>(v)));
     return s.to_vector();
   }
-  template <typename... Args>
-  outcome::result<void> encode(ScaleEncoderStream &s, Args &&...args) {
+  template <typename C, typename... Args>
+  outcome::result<void> encode(BasicScaleEncoderStream<C> &s,
+                               Args &&...args) {
     return outcomeCatch([&] { (s << ... << std::forward<Args>(args)); });
   }
 
   /**
    * @brief convenience function for decoding primitives data from stream
    * @tparam T primitive type that is decoded from provided span
+   * @tparam CompactCodec codec of compact integers
    * @param span of bytes with encoded data
    * @return decoded T
    */
-  template <typename T>
+  template <typename T, typename CompactCodec = DefaultCompactCodec>
   outcome::result<T> decode(ConstSpanOfBytes data) {
-    ScaleDecoderStream s(data);
+    BasicScaleDecoderStream<CompactCodec> s(data);
     return decode<T>(s);
   }
-  template <typename T>
-  outcome::result<T> decode(ScaleDecoderStream &s) {
-    T t{};
-    OUTCOME_TRY(decode<T>(s, t));
-    return outcome::success(std::move(t));
+  template <typename T, typename C>
+  outcome::result<T> decode(BasicScaleDecoderStream<C> &s) {
+    return outcomeCatch([&] { return s.template decodeValue<T>(); });
   }
-  template <typename T>
-  outcome::result<void> decode(ScaleDecoderStream &s, T &t) {
+  template <typename T, typename C>
+  outcome::result<void> decode(BasicScaleDecoderStream<C> &s, T &t) {
     return outcomeCatch([&] { s >> t; });
   }
 
+  /**
+   * @brief convenience function for decoding sequence to beginning of
+   * caller-provided buffer without allocations
+   * @tparam T type of item
+   * @param s stream to decode from
+   * @param out buffer for items, its size is max count of items
+   * @return count of decoded items
+   */
+  template <typename T, size_t N, typename C>
+  outcome::result<size_t> decode_into(BasicScaleDecoderStream<C> &s,
+                                      std::span<T, N> out) {
+    return outcomeCatch([&] { return s.decodeInto(out); });
+  }
+
 #ifdef CUSTOM_CONFIG_ENABLED
   template <typename T>
-    requires(not std::derived_from<std::remove_cvref_t<T>, ScaleEncoderStream>)
+    requires(not EncoderStream<T>)
   outcome::result<ByteArray> encode(const T &v, const auto &config) {
     ScaleEncoderStream s(config);
     OUTCOME_TRY(encode(s, v));
@@ -80,7 +95,7 @@ namespace scale {
   }
 
   template <typename T>
-    requires(not std::derived_from<std::remove_cvref_t<T>, ScaleEncoderStream>)
+    requires(not EncoderStream<T>)
   outcome::result<T> decode(ConstSpanOfBytes bytes, const auto &config) {
     ScaleDecoderStream s(bytes, config);
     T t;
@@ -6,9 +6,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -26,64 +31,94 @@
 #endif
 
 #include <scale/bitvec.hpp>
+#include <scale/columns.hpp>
+#include <scale/compact_codec.hpp>
 #include <scale/definitions.hpp>
 #include <scale/detail/aggregate.hpp>
 #include <scale/detail/fixed_width_integer.hpp>
-#ifdef JAM_COMPATIBILITY_ENABLED
-#include <scale/detail/jam_compact_integer.hpp>
-#else
-#include <scale/detail/compact_integer.hpp>
-#endif
+#include <scale/detail/memory_resource.hpp>
+#include <scale/detail/simd.hpp>
+#include <scale/flat_nested.hpp>
 #include <scale/configurable.hpp>
+#include <scale/memcpy_codable.hpp>
+#include <scale/min_encoded_size.hpp>
 #include <scale/scale_error.hpp>
 #include <scale/types.hpp>
+#include <scale/utf8_string.hpp>
 
 namespace scale {
-  class ScaleDecoderStream : public Configurable {
+  /**
+   * @class BasicScaleDecoderStream designed to scale-decode data from span
+   * @tparam CompactCodec codec of compact integers, ScaleCompactCodec or
+   * JamCompactCodec
+   */
+  template <typename CompactCodec>
+  class BasicScaleDecoderStream : public Configurable {
    public:
     // special tag to differentiate decoding streams from others
     static constexpr auto is_decoder_stream = true;
 
-    explicit ScaleDecoderStream(ConstSpanOfBytes data) : span_{data} {}
+    explicit BasicScaleDecoderStream(ConstSpanOfBytes data) : span_{data} {}
 
 #ifdef CUSTOM_CONFIG_ENABLED
-    explicit ScaleDecoderStream(ConstSpanOfBytes data,
-                                const MaybeConfig auto &...configs)
+    explicit BasicScaleDecoderStream(ConstSpanOfBytes data,
+                                     const MaybeConfig auto &...configs)
         : Configurable(configs...), span_{data} {}
 #else
     [[deprecated("Scale has compiled without custom config support")]]  //
-    ScaleDecoderStream(ConstSpanOfBytes data,
-                       const MaybeConfig auto &...configs) = delete;
+    BasicScaleDecoderStream(ConstSpanOfBytes data,
+                            const MaybeConfig auto &...configs) = delete;
 #endif
 
     template <typename T>
       requires CompactCompatible<T>
     T decodeCompact() {
-      auto integer =
-#ifdef JAM_COMPATIBILITY_ENABLED
-          detail::decodeJamCompactInteger(*this);
-#else
-          detail::decodeCompactInteger(*this);
-#endif
-      if constexpr (std::is_integral_v<T>) {
-        if (not integer.is_zero()
-            and msb(integer) >= std::numeric_limits<T>::digits) {
-          raise(DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+      return CompactCodec::template decode<T>(*this);
+    }
+
+    /**
+     * @brief scale-decodes value from scratch. Value of type, which is not
+     * default constructible, is constructed once from its decoded fields.
+     * If memory resource is set, values allocating by polymorphic allocator
+     * are constructed by it.
+     * @tparam T type of value
+     * @return decoded value
+     */
+    template <DecodableValue T>
+    T decodeValue() {
+      if constexpr (detail::usesMemoryResource<T>()) {
+        if (memory_resource_ != nullptr) {
+          return decodeByMemoryResource<T>();
         }
       }
-      return static_cast<T>(integer);
+      if constexpr (std::is_default_constructible_v<T>) {
+        T v{};
+        *this >> v;
+        return v;
+      } else {
+        return constructFromFields<T>(
+            std::type_identity<typename detail::fields_of<T>::type>{});
+      }
     }
 
     /**
-     * @brief scale-decodes aggregate
+     * @brief scale-decodes aggregate, padding-free aggregate of
+     * memcpy-codable fields is copied from stream at once
      * @param v aggregate for decoding to
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(SimpleCodeableAggregate auto &v)
+    BasicScaleDecoderStream &operator>>(SimpleCodeableAggregate auto &v)
       requires(not qtils::is_tagged_v<decltype(v)>)
     {
+      static_assert(detail::decoder_fits_codec<CompactCodec, decltype(v)>,
+                    "operator>> of type is written for ScaleDecoderStream "
+                    "only, make it template of BasicScaleDecoderStream<C>");
+      if constexpr (MemcpyCodable<decltype(v)>) {
+        std::memcpy(&v, nextBytes(sizeof(v)).data(), sizeof(v));
+        return *this;
+      }
       return detail::decompose_and_apply(
-          v, [&](auto &...args) -> ScaleDecoderStream & {
+          v, [&](auto &...args) -> BasicScaleDecoderStream & {
             return (*this >> ... >> args);
           });
     }
@@ -93,12 +128,16 @@ namespace scale {
      * @param v object for decoding to
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(CustomDecomposable auto &v)
+    BasicScaleDecoderStream &operator>>(CustomDecomposable auto &v)
       requires(not qtils::is_tagged_v<decltype(v)>)
     {
-      return decompose_and_apply(v, [&](auto &...args) -> ScaleDecoderStream & {
-        return (*this >> ... >> args);
-      });
+      static_assert(detail::decoder_fits_codec<CompactCodec, decltype(v)>,
+                    "operator>> of type is written for ScaleDecoderStream "
+                    "only, make it template of BasicScaleDecoderStream<C>");
+      return decompose_and_apply(
+          v, [&](auto &...args) -> BasicScaleDecoderStream & {
+            return (*this >> ... >> args);
+          });
     }
 
     /**
@@ -110,7 +149,7 @@ namespace scale {
      */
     template <class F, class S>
       requires(not std::is_reference_v<F> and not std::is_reference_v<S>)
-    ScaleDecoderStream &operator>>(std::pair<F, S> &p) {
+    BasicScaleDecoderStream &operator>>(std::pair<F, S> &p) {
       using mutableF = std::remove_cvref_t<F>;
       using mutableS = std::remove_cvref_t<S>;
       return *this                                 //
@@ -125,7 +164,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... T>
-    ScaleDecoderStream &operator>>(std::tuple<T...> &v) {
+    BasicScaleDecoderStream &operator>>(std::tuple<T...> &v) {
       if constexpr (sizeof...(T) > 0) {
         decodeElementOfTuple<0>(v);
       }
@@ -139,7 +178,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... Ts>
-    ScaleDecoderStream &operator>>(std::variant<Ts...> &v) {
+    BasicScaleDecoderStream &operator>>(std::variant<Ts...> &v) {
       // first byte means type index
       uint8_t type_index = 0u;
       *this >> type_index;  // decode type index
@@ -161,7 +200,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... Ts>
-    ScaleDecoderStream &operator>>(boost::variant<Ts...> &v) {
+    BasicScaleDecoderStream &operator>>(boost::variant<Ts...> &v) {
       // first byte means type index
       uint8_t type_index = 0u;
       *this >> type_index;  // decode type index
@@ -182,12 +221,22 @@ namespace scale {
      * @param v value to decode
      * @return reference to stream
      */
-    template <typename T>
-      requires std::is_default_constructible_v<std::remove_cvref_t<T>>
-    ScaleDecoderStream &operator>>(std::shared_ptr<T> &v) {
+    template <DecodableValue T>
+    BasicScaleDecoderStream &operator>>(std::shared_ptr<T> &v) {
       using mutableT = std::remove_cvref_t<T>;
-      v = std::make_shared<mutableT>();
-      return *this >> const_cast<mutableT &>(*v);  // NOLINT
+      if constexpr (ConstructibleFromFields<T>) {
+        chargeAllocation(1, sizeof(mutableT));
+        v = makeShared<mutableT>(DecodedValue<mutableT>{*this});
+      } else {
+        // pointed object is reused only if nobody else shares it
+        if (not(reusing_storage_ and not std::is_const_v<T> and v
+                and v.use_count() == 1)) {
+          chargeAllocation(1, sizeof(mutableT));
+          v = makeShared<mutableT>();
+        }
+        *this >> const_cast<mutableT &>(*v);  // NOLINT
+      }
+      return *this;
     }
 
     /**
@@ -196,12 +245,20 @@ namespace scale {
      * @param v value to decode
      * @return reference to stream
      */
-    template <typename T>
-      requires std::is_default_constructible_v<std::remove_cvref_t<T>>
-    ScaleDecoderStream &operator>>(std::unique_ptr<T> &v) {
+    template <DecodableValue T>
+    BasicScaleDecoderStream &operator>>(std::unique_ptr<T> &v) {
       using mutableT = std::remove_cvref_t<T>;
-      v = std::make_unique<mutableT>();
-      return *this >> const_cast<mutableT &>(*v);  // NOLINT
+      if constexpr (ConstructibleFromFields<T>) {
+        chargeAllocation(1, sizeof(mutableT));
+        v = std::make_unique<mutableT>(DecodedValue<mutableT>{*this});
+      } else {
+        if (not(reusing_storage_ and not std::is_const_v<T> and v)) {
+          chargeAllocation(1, sizeof(mutableT));
+          v = std::make_unique<mutableT>();
+        }
+        *this >> const_cast<mutableT &>(*v);  // NOLINT
+      }
+      return *this;
     }
 
     /**
@@ -212,7 +269,7 @@ namespace scale {
      */
     template <typename T>
       requires std::is_integral_v<std::remove_cvref_t<T>>
-    ScaleDecoderStream &operator>>(T &v) {
+    BasicScaleDecoderStream &operator>>(T &v) {
       using I = std::decay_t<T>;
       // check bool
       if constexpr (std::is_same_v<I, bool>) {
@@ -241,7 +298,7 @@ namespace scale {
      * @param v value of integral type
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(BigFixedWidthInteger auto &v) {
+    BasicScaleDecoderStream &operator>>(BigFixedWidthInteger auto &v) {
       decodeInteger(v, *this);
       return *this;
     }
@@ -252,9 +309,8 @@ namespace scale {
      * @param v optional value reference
      * @return reference to stream
      */
-    template <typename T>
-      requires std::is_default_constructible_v<std::remove_cvref_t<T>>
-    ScaleDecoderStream &operator>>(std::optional<T> &v) {
+    template <DecodableValue T>
+    BasicScaleDecoderStream &operator>>(std::optional<T> &v) {
       using mutableT = std::remove_cvref_t<T>;
 
       // Special case for `std::optional<bool>`
@@ -273,8 +329,19 @@ namespace scale {
       }
 
       // Decode the value
-      v.emplace();  // Initialize the object inside the optional
-      return *this >> const_cast<mutableT &>(*v);  // NOLINT
+      if constexpr (ConstructibleFromFields<T>) {
+        v.emplace(DecodedValue<mutableT>{*this});
+      } else {
+        if (reusing_storage_ and v.has_value()) {
+          *this >> const_cast<mutableT &>(*v);  // NOLINT
+        } else if (usingMemoryResource<mutableT>()) {
+          v.emplace(DecodedValue<mutableT>{*this});
+        } else {
+          v.emplace();  // Initialize the object inside the optional
+          *this >> const_cast<mutableT &>(*v);  // NOLINT
+        }
+      }
+      return *this;
     }
 
     /**
@@ -282,19 +349,37 @@ namespace scale {
      * @param v compact integer reference
      * @return
      */
-    ScaleDecoderStream &operator>>(CompactInteger auto &v) {
+    BasicScaleDecoderStream &operator>>(CompactInteger auto &v) {
       v = decodeCompact<qtils::untagged_t<decltype(v)>>();
       return *this;
     }
 
     /**
-     * @brief scale-decodes to any static (fixed-size) collection
+     * @brief scale-decodes to any static (fixed-size) collection, contiguous
+     * collection of memcpy-codable items is copied from stream at once
      * @param collection decoding collection to
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(StaticCollection auto &collection)
+    BasicScaleDecoderStream &operator>>(StaticCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
     {
+      using Collection = std::remove_cvref_t<decltype(collection)>;
+      if constexpr (MemcpyCodableRange<Collection>) {
+        using Item = std::ranges::range_value_t<Collection>;
+        auto bytes = nextBytesOf<Item>(std::ranges::size(collection));
+        if (not bytes.empty()) {
+          std::memcpy(
+              std::ranges::data(collection), bytes.data(), bytes.size());
+        }
+        return *this;
+      } else if constexpr (BoolContiguousRange<Collection>) {
+        auto bytes = nextBoolBytes(std::ranges::size(collection));
+        if (not bytes.empty()) {
+          std::memcpy(
+              std::ranges::data(collection), bytes.data(), bytes.size());
+        }
+        return *this;
+      }
       for (auto &item : collection) {
         *this >> item;
       }
@@ -303,40 +388,127 @@ namespace scale {
 
     /**
      * @brief scale-decodes to resizeable collection (which can be resized first
-     * and rewrite elements while decoding)
+     * and rewrite elements while decoding), contiguous collection of
+     * memcpy-codable items is filled from stream at once
      * @param collection decoding collection to
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(ResizeableCollection auto &collection)
+    BasicScaleDecoderStream &operator>>(ResizeableCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
+              and (not BoolVector<decltype(collection)>)
     {
+      auto item_count = decodeCompact<size_t>();
+      // fixed-capacity containers (e.g. static_vector) report capacity as
+      // max_size(), so oversized input is rejected before any resize
+      if (item_count > collection.max_size()) {
+        raise(DecodeError::TOO_MANY_ITEMS);
+      }
+
+      using Collection = std::remove_cvref_t<decltype(collection)>;
+      using Item = std::ranges::range_value_t<Collection>;
+      if constexpr (MemcpyCodableRange<Collection>
+                    or BoolContiguousRange<Collection>) {
+        auto bytes = std::same_as<Item, bool> ? nextBoolBytes(item_count)
+                                              : nextBytesOf<Item>(item_count);
+        chargeAllocation(item_count, sizeof(Item));
+        try {
+          detail::assignFromBytes(collection, bytes);
+        } catch (const std::bad_alloc &) {
+          raise(DecodeError::TOO_MANY_ITEMS);
+        }
+        return *this;
+      } else if constexpr (ConstructibleFromFields<Item>
+                           or (detail::usesMemoryResource<Item>()
+                               and HasEmplaceBackMethod<Collection>)) {
+        checkItemCount<Item>(item_count);
+        chargeAllocation(item_count, sizeof(Item));
+        if constexpr (not ConstructibleFromFields<Item>) {
+          if (not usingMemoryResource<Item>()) {
+            return decodeByResize(collection, item_count);
+          }
+        }
+        // items are constructed from decoded fields right in collection
+        collection.clear();
+        try {
+          if constexpr (HasReserveMethod<Collection>) {
+            collection.reserve(reservableCount<Item>(item_count));
+          }
+          for (size_t i = 0; i < item_count; ++i) {
+            collection.emplace_back(DecodedValue<Item>{*this});
+          }
+        } catch (const std::bad_alloc &) {
+          raise(DecodeError::TOO_MANY_ITEMS);
+        }
+        return *this;
+      } else {
+        checkItemCount<Item>(item_count);
+        chargeAllocation(item_count, sizeof(Item));
+        return decodeByResize(collection, item_count);
+      }
+    }
+
+    /**
+     * @brief Specification for vector<bool>, all bytes are validated at once
+     * and unpacked by words
+     * @param v reference to container
+     * @return reference to stream
+     */
+    BasicScaleDecoderStream &operator>>(BoolVector auto &collection) {
       auto item_count = decodeCompact<size_t>();
       if (item_count > collection.max_size()) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
+      auto bytes = nextBoolBytes(item_count);
+      chargeAllocation(item_count / 8 + (item_count % 8 != 0), 1);
       try {
-        collection.resize(item_count);
+        collection.assign(item_count, false);
       } catch (const std::bad_alloc &) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
-      for (auto &item : collection) {
-        *this >> item;
+      // validated bytes are packed into words, so unset bits are skipped by
+      // words and words of set bits are filled at once
+      constexpr size_t kWordBits = 64;
+      for (size_t first = 0; first < item_count; first += kWordBits) {
+        auto word_bytes = bytes.subspan(first);
+        uint64_t word = 0;
+        for (size_t i = 0; i < kWordBits and i < word_bytes.size(); i += 8) {
+          word |= uint64_t{detail::packBytesToBits(word_bytes.subspan(i))}
+               << i;
+        }
+        if (word == ~uint64_t{0}) {
+          std::fill_n(collection.begin() + first, kWordBits, true);
+          continue;
+        }
+        for (; word != 0; word &= word - 1) {
+          collection[first + std::countr_zero(word)] = true;
+        }
       }
       return *this;
     }
 
     /**
-     * @brief Specification for vector<bool>
-     * @param v reference to container
+     * @brief Specification for vector of native compact integers with fast
+     * path for runs of single-byte items only. Such runs are detected by
+     * vectorized scan while they are long, otherwise items are decoded one by
+     * one until such run appears again, so multibyte items do not pay for
+     * scans. Mode bytes of multibyte items are not classified in bulk: mixed
+     * 1/2/4-byte items are decoded by the scalar codec.
+     * @param collection reference to container
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(std::vector<bool> &collection) {
+    template <std::unsigned_integral T>
+    BasicScaleDecoderStream &operator>>(std::vector<Compact<T>> &collection) {
       auto item_count = decodeCompact<size_t>();
       if (item_count > collection.max_size()) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
+      // each item takes one byte at least
+      if (not hasMore(item_count)) {
+        raise(DecodeError::NOT_ENOUGH_DATA);
+      }
+      chargeAllocation(item_count, sizeof(Compact<T>));
 
       try {
         collection.resize(item_count);
@@ -344,81 +516,257 @@ namespace scale {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
-      bool item;
-      for (size_t i = 0u; i < item_count; ++i) {
-        *this >> item;
-        collection[i] = item;
+      // shorter runs are not worth vectorized scan
+      constexpr size_t kMinScannedRun = 16;
+      bool scanning = true;
+      size_t streak = 0;
+      for (size_t i = 0; i < item_count;) {
+        if (scanning) {
+          auto bytes = span_.subspan(
+              current_index_,
+              std::min(item_count - i, span_.size() - current_index_));
+          auto run = detail::countLeadingBytesWithClearBits(
+              bytes, CompactCodec::kMultiByteBits);
+          for (size_t k = 0; k < run; ++k) {
+            collection[i + k] = static_cast<T>(
+                bytes[k] >> CompactCodec::kSingleByteShift);
+          }
+          i += run;
+          current_index_ += run;
+          scanning = run >= kMinScannedRun;
+          streak = 0;
+          if (i < item_count) {
+            collection[i++] = decodeCompact<T>();
+          }
+        } else if (current_index_ < span_.size()
+                   and (span_[current_index_] & CompactCodec::kMultiByteBits)
+                           == 0) {
+          collection[i++] = static_cast<T>(span_[current_index_++]
+                                           >> CompactCodec::kSingleByteShift);
+          scanning = ++streak == kMinScannedRun;
+        } else {
+          streak = 0;
+          collection[i++] = decodeCompact<T>();
+        }
       }
-
       return *this;
     }
 
     /**
      * @brief scale-decodes BitVec
      */
-    ScaleDecoderStream &operator>>(BitVec &v);
+    BasicScaleDecoderStream &operator>>(BitVec &v);
+
+    /**
+     * @brief scale-decodes PackedBitVec
+     */
+    BasicScaleDecoderStream &operator>>(PackedBitVec &v);
+
+    /**
+     * @brief scale-decodes vector of vectors to FlatNested. Length prefixes
+     * are walked through first, so both buffers are allocated once with
+     * exact sizes, then items are copied.
+     * @param v sequence of sequences
+     * @return reference to stream
+     */
+    template <typename T>
+    BasicScaleDecoderStream &operator>>(FlatNested<T> &v) {
+      auto count = decodeCompact<size_t>();
+      const auto begin = current_index_;
+      size_t total_items = 0;
+      for (size_t i = 0; i < count; ++i) {
+        auto size = decodeCompact<size_t>();
+        nextBytesOf<T>(size);
+        total_items += size;
+      }
+      current_index_ = begin;
+      chargeAllocation(count + 1, sizeof(size_t));
+      chargeAllocation(total_items, sizeof(T));
+
+      v.clear();
+      try {
+        v.reserve(count, total_items);
+        for (size_t i = 0; i < count; ++i) {
+          auto size = decodeCompact<size_t>();
+          v.pushBackEncoded(nextBytes(size * sizeof(T)));
+        }
+      } catch (const std::bad_alloc &) {
+        raise(DecodeError::TOO_MANY_ITEMS);
+      }
+      return *this;
+    }
+
+    /**
+     * @brief scale-decodes vector of aggregates to columns, records of fixed
+     * width are taken at once and split to columns by strided copies
+     * @param v columns of records
+     * @return reference to stream
+     */
+    template <typename A>
+    BasicScaleDecoderStream &operator>>(Columns<A> &v) {
+      using Records = Columns<A>;
+      auto count = decodeCompact<size_t>();
+      v.clear();
+      try {
+        if constexpr (Records::kFixedWidth) {
+          if (count > (span_.size() - current_index_) / Records::kRecordSize) {
+            raise(DecodeError::NOT_ENOUGH_DATA);
+          }
+          chargeAllocation(count, Records::kRecordSize);
+          auto records = nextBytes(count * Records::kRecordSize);
+          v.resize(count);
+          v.assignRecords(records);
+          return *this;
+        }
+        checkItemCount<A>(count);
+        chargeAllocation(count, Records::kRecordSize);
+        v.reserve(reservableCount<A>(count));
+        for (size_t i = 0; i < count; ++i) {
+          [&]<size_t... I>(std::index_sequence<I...>) {
+            (decodeAndAppend(v.template column<I>()), ...);
+          }(std::make_index_sequence<Records::kFieldCount>{});
+        }
+      } catch (const std::bad_alloc &) {
+        raise(DecodeError::TOO_MANY_ITEMS);
+      }
+      return *this;
+    }
+
+    /**
+     * @brief scale-decodes string validating it is UTF-8
+     */
+    BasicScaleDecoderStream &operator>>(ValidatedUtf8String &v);
 
     /// @note Implementation prohibited as potentially dangerous.
-    /// Use manual decoding instead
-    ScaleDecoderStream &operator>>(DynamicSpan auto &collection) = delete;
+    /// Use decodeInto() or manual decoding instead
+    BasicScaleDecoderStream &operator>>(DynamicSpan auto &collection) = delete;
+
+    /**
+     * @brief scale-decodes sequence (e.g. std::vector<T>) to beginning of
+     * caller-provided buffer, so no allocation is made. Memcpy-codable items
+     * are copied from stream at once.
+     * @param out buffer for items
+     * @return count of decoded items
+     */
+    template <typename T, size_t N>
+      requires(not std::is_const_v<T>)
+    size_t decodeInto(std::span<T, N> out) {
+      auto item_count = decodeCompact<size_t>();
+      if (item_count > out.size()) {
+        raise(DecodeError::TOO_MANY_ITEMS);
+      }
+
+      auto items = out.first(item_count);
+      if constexpr (MemcpyCodable<T> or std::same_as<T, bool>) {
+        auto bytes = std::same_as<T, bool> ? nextBoolBytes(item_count)
+                                           : nextBytesOf<T>(item_count);
+        if (not bytes.empty()) {
+          std::memcpy(items.data(), bytes.data(), bytes.size());
+        }
+        return item_count;
+      }
+
+      checkItemCount<T>(item_count);
+      for (auto &item : items) {
+        *this >> item;
+      }
+      return item_count;
+    }
 
     /**
      * @brief scale-decodes to sequential collection (which can be reserved
      * space first and push element by element back while decoding)
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(ExtensibleBackCollection auto &collection)
+    BasicScaleDecoderStream &operator>>(
+        ExtensibleBackCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
     {
       using size_type = typename std::decay_t<decltype(collection)>::size_type;
+      using Item = std::ranges::range_value_t<decltype(collection)>;
 
       auto item_count = decodeCompact<size_t>();
       if (item_count > collection.max_size()) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
-      collection.clear();
+      checkItemCount<Item>(item_count);
+      chargeAllocation(item_count, sizeof(Item));
+
+      // items are constructed in place, if they can not be decoded into
+      const bool construct_items =
+          ConstructibleFromFields<Item> or usingMemoryResource<Item>();
+
+      size_type i = 0u;
+      if constexpr (ConstructibleFromFields<Item>) {
+        collection.clear();
+      } else if (reusing_storage_ and not construct_items) {
+        // existing items are overwritten in place, extra ones are dropped
+        for (auto it = collection.begin();
+             it != collection.end() and i < item_count;
+             ++it, ++i) {
+          *this >> *it;
+        }
+        if (collection.size() > item_count) {
+          collection.erase(std::next(collection.begin(), item_count),
+                           collection.end());
+        }
+      } else {
+        collection.clear();
+      }
       try {
-        collection.reserve(item_count);
+        collection.reserve(reservableCount<Item>(item_count));
       } catch (const std::bad_alloc &) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
-      for (size_type i = 0u; i < item_count; ++i) {
-        collection.emplace_back();
-        *this >> collection.back();
+      for (; i < item_count; ++i) {
+        if constexpr (ConstructibleFromFields<Item>) {
+          collection.emplace_back(DecodedValue<Item>{*this});
+        } else if (construct_items) {
+          collection.emplace_back(DecodedValue<Item>{*this});
+        } else {
+          collection.emplace_back();
+          *this >> collection.back();
+        }
       }
       return *this;
     }
 
     /**
      * @brief scale-decodes to non-sequential collection (which can not be
-     * reserved space or resize, but each element can be emplaced while
-     * decoding)
+     * resized, but each element can be emplaced while decoding). Items of
+     * ordered containers are expected in ascending order, as maps and sets
+     * are encoded, and are appended by hint at end. Hash containers are
+     * reserved first, within count of items remaining data could hold.
      * @return reference to stream
      */
-    ScaleDecoderStream &operator>>(RandomExtensibleCollection auto &collection)
+    BasicScaleDecoderStream &operator>>(
+        RandomExtensibleCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
     {
-      using size_type = typename std::decay_t<decltype(collection)>::size_type;
-      using value_type =
-          typename std::decay_t<decltype(collection)>::value_type;
+      using Collection = std::decay_t<decltype(collection)>;
+      using size_type = typename Collection::size_type;
+      using value_type = typename Collection::value_type;
 
       auto item_count = decodeCompact<size_t>();
       if (item_count > collection.max_size()) {
         raise(DecodeError::TOO_MANY_ITEMS);
       }
 
-      value_type item;
+      checkItemCount<value_type>(item_count);
+      chargeAllocation(item_count, sizeof(value_type));
 
       collection.clear();
-      for (size_type i = 0u; i < item_count; ++i) {
-        *this >> item;
-        try {
-          collection.emplace(std::move(item));
-        } catch (const std::bad_alloc &) {
-          raise(DecodeError::TOO_MANY_ITEMS);
+      try {
+        if constexpr (HasReserveMethod<Collection>) {
+          collection.reserve(reservableCount<value_type>(item_count));
         }
+        for (size_type i = 0u; i < item_count; ++i) {
+          emplaceDecoded(collection, decodeValue<value_type>());
+        }
+      } catch (const std::bad_alloc &) {
+        raise(DecodeError::TOO_MANY_ITEMS);
       }
       return *this;
     }
@@ -437,6 +785,14 @@ namespace scale {
      */
     uint8_t nextByte();
 
+    /**
+     * @brief takes n bytes from stream at once and
+     * advances current byte iterator by n
+     * @param n Number of bytes to take
+     * @return span of taken bytes
+     */
+    ConstSpanOfBytes nextBytes(size_t n);
+
     using ByteSpan = ConstSpanOfBytes;
     using SpanIterator = ByteSpan::iterator;
     using SizeType = ByteSpan::size_type;
@@ -448,7 +804,282 @@ namespace scale {
       return current_index_;
     }
 
+    /**
+     * @brief enables rejection of maps and sets, whose keys are not encoded
+     * in canonical order, i.e. unsorted or duplicated keys of ordered
+     * containers and duplicated keys of unordered ones. Such input is
+     * silently deduplicated otherwise.
+     * @param strict true to reject non-canonical input
+     */
+    void setStrictOrdering(bool strict) {
+      strict_ordering_ = strict;
+    }
+
+    bool isStrictOrdering() const {
+      return strict_ordering_;
+    }
+
+    /**
+     * @brief enables decoding into existing storage of decoded object, so
+     * repeated decoding of similar values into the same object stops
+     * allocating: items of sequences are overwritten in place and only their
+     * tail grows or shrinks, values of optionals, objects owned by pointers
+     * and matching alternatives of variants are decoded into.
+     * Maps and sets are still rebuilt.
+     * @param reuse true to reuse storage
+     */
+    void setReusingStorage(bool reuse) {
+      reusing_storage_ = reuse;
+    }
+
+    bool isReusingStorage() const {
+      return reusing_storage_;
+    }
+
+    /**
+     * @brief sets memory resource, which allocates decoded values: values of
+     * std::pmr containers and strings (and aggregates, pairs, tuples and
+     * optionals of them) are constructed with polymorphic allocator of the
+     * resource, their items are allocated by it in turn, and objects owned
+     * by shared_ptr are allocated by it too. With monotonic resource per
+     * decoded block all allocations are pointer bumps and are released at
+     * once. Containers passed to decoder keep their own allocators.
+     * @param resource memory resource, nullptr to use default allocation
+     */
+    void setMemoryResource(std::pmr::memory_resource *resource) {
+      memory_resource_ = resource;
+    }
+
+    std::pmr::memory_resource *memoryResource() const {
+      return memory_resource_;
+    }
+
+    /**
+     * @brief limits total size of memory taken by decoded values: items of
+     * collections, strings and pointed objects are charged before they are
+     * allocated, and decoding fails with ALLOCATION_BUDGET_EXCEEDED once the
+     * budget runs out. Nested collections are charged at each level.
+     * @param bytes budget in bytes, std::nullopt for no limit
+     */
+    void setAllocationBudget(std::optional<size_t> bytes) {
+      allocation_budget_ = bytes;
+    }
+
+    /**
+     * @return remaining allocation budget, std::nullopt if it is not limited
+     */
+    std::optional<size_t> allocationBudget() const {
+      return allocation_budget_;
+    }
+
    private:
+    /**
+     * @brief takes bytes of n memcpy-codable items from stream at once
+     * @tparam T type of item
+     * @param n Number of items
+     * @return span of taken bytes
+     */
+    template <typename T>
+    ConstSpanOfBytes nextBytesOf(size_t n) {
+      if (n > (span_.size() - current_index_) / sizeof(T)) {
+        raise(DecodeError::NOT_ENOUGH_DATA);
+      }
+      return nextBytes(n * sizeof(T));
+    }
+
+    /**
+     * @brief takes bytes of n bools from stream at once and checks that each
+     * of them is 0 or 1
+     * @param n Number of bools
+     * @return span of taken bytes
+     */
+    ConstSpanOfBytes nextBoolBytes(size_t n);
+
+    /**
+     * @brief resizes collection and decodes its items in place
+     * @param collection collection of default constructible items
+     * @param item_count count of items
+     * @return reference to stream
+     */
+    template <typename Collection>
+    BasicScaleDecoderStream &decodeByResize(Collection &collection,
+                                            size_t item_count) {
+      try {
+        collection.resize(item_count);
+      } catch (const std::bad_alloc &) {
+        raise(DecodeError::TOO_MANY_ITEMS);
+      }
+
+      for (auto &item : collection) {
+        *this >> item;
+      }
+      return *this;
+    }
+
+    /**
+     * @return true if value of type is constructed by memory resource
+     * @tparam T type of value
+     */
+    template <typename T>
+    bool usingMemoryResource() const {
+      if constexpr (detail::usesMemoryResource<T>()) {
+        return memory_resource_ != nullptr;
+      } else {
+        return false;
+      }
+    }
+
+    /**
+     * @brief creates object owned by shared_ptr, if memory resource is set,
+     * object is allocated by it together with control block
+     * @tparam T type of object
+     * @param args arguments of constructor
+     * @return pointer to created object
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeShared(Args &&...args) {
+      if (memory_resource_ != nullptr) {
+        return std::allocate_shared<T>(
+            std::pmr::polymorphic_allocator<T>(memory_resource_),
+            std::forward<Args>(args)...);
+      }
+      return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief decodes value constructed by memory resource: aggregate is
+     * constructed from fields decoded by memory resource, other values are
+     * constructed with polymorphic allocator and decoded into
+     * @tparam T type of value
+     * @return decoded value
+     */
+    template <typename T>
+    T decodeByMemoryResource() {
+      if constexpr (SimpleCodeableAggregate<T> or ConstructibleFromFields<T>) {
+        return constructFromFields<T>(
+            std::type_identity<typename detail::fields_of<T>::type>{});
+      } else if constexpr (detail::is_optional<T>::value) {
+        T v;
+        *this >> v;
+        return v;
+      } else {
+        auto v = std::make_obj_using_allocator<T>(
+            std::pmr::polymorphic_allocator<>(memory_resource_));
+        *this >> v;
+        return v;
+      }
+    }
+
+    /**
+     * @brief Converts to value decoded from stream, so containers construct
+     * it in place by emplace
+     * @tparam T type of value
+     */
+    template <typename T>
+    struct DecodedValue {
+      BasicScaleDecoderStream &stream;
+
+      operator T() const {  // NOLINT(google-explicit-constructor)
+        return stream.template decodeValue<T>();
+      }
+    };
+
+    /**
+     * @brief constructs value once from its fields decoded in order, braced
+     * initialization guarantees order of evaluation of decodeValue()
+     * @tparam T type of value
+     * @tparam F types of fields
+     * @return constructed value
+     */
+    template <typename T, typename... F>
+    T constructFromFields(std::type_identity<std::tuple<F...>>) {
+      return T{decodeValue<std::remove_cv_t<F>>()...};
+    }
+
+    /**
+     * @brief charges allocation budget for memory of n items
+     * @param n Number of items
+     * @param item_size size of item in memory
+     */
+    void chargeAllocation(size_t n, size_t item_size) {
+      if (not allocation_budget_) {
+        return;
+      }
+      if (item_size != 0 and n > *allocation_budget_ / item_size) {
+        raise(DecodeError::ALLOCATION_BUDGET_EXCEEDED);
+      }
+      *allocation_budget_ -= n * item_size;
+    }
+
+    /**
+     * @brief checks that remaining data could hold n items, each of them
+     * taking min_encoded_size of bytes at least, before room for them is
+     * allocated
+     * @tparam T type of item
+     * @param n Number of items
+     */
+    template <typename T>
+    void checkItemCount(size_t n) const {
+      constexpr auto kMinSize = min_encoded_size_v<T>;
+      if constexpr (kMinSize != 0) {
+        if (n > (span_.size() - current_index_) / kMinSize) {
+          raise(DecodeError::NOT_ENOUGH_DATA);
+        }
+      }
+    }
+
+    /**
+     * @brief count of items to reserve room for, clamped by count of items
+     * remaining data could hold, an item of unknown size is assumed to take
+     * one byte at least
+     * @tparam T type of item
+     * @param n Number of items
+     * @return count of items to reserve
+     */
+    template <typename T>
+    size_t reservableCount(size_t n) const {
+      constexpr auto kMinSize = std::max<size_t>(min_encoded_size_v<T>, 1);
+      return std::min(n, (span_.size() - current_index_) / kMinSize);
+    }
+
+    /**
+     * @brief emplaces decoded item to map or set, checks canonical order of
+     * items if strict ordering is enabled
+     * @param collection collection to emplace to
+     * @param item decoded item
+     */
+    template <typename Collection, typename Item>
+    void emplaceDecoded(Collection &collection, Item &&item) {
+      if constexpr (requires { typename Collection::key_compare; }) {
+        const auto size = collection.size();
+        auto it =
+            collection.emplace_hint(collection.end(), std::forward<Item>(item));
+        if (strict_ordering_
+            and (collection.size() == size
+                 or std::next(it) != collection.end())) {
+          raise(DecodeError::NOT_CANONICAL_ORDER);
+        }
+      } else if constexpr (requires { collection.emplace(item).second; }) {
+        auto inserted = collection.emplace(std::forward<Item>(item)).second;
+        if (strict_ordering_ and not inserted) {
+          raise(DecodeError::NOT_CANONICAL_ORDER);
+        }
+      } else {
+        collection.emplace(std::forward<Item>(item));
+      }
+    }
+
+    /**
+     * @brief decodes item and appends it to vector
+     * @param items vector to append to
+     */
+    template <typename T>
+    void decodeAndAppend(std::vector<T> &items) {
+      T item{};
+      *this >> item;
+      items.push_back(std::move(item));
+    }
+
     bool decodeBool();
     /**
      * @brief special case of optional values as described in specification
@@ -459,9 +1090,15 @@ namespace scale {
     template <size_t I, class... Ts>
     void decodeElementOfTuple(std::tuple<Ts...> &v) {
       using T = std::remove_cvref_t<std::tuple_element_t<I, std::tuple<Ts...>>>;
-      static_assert(std::is_default_constructible_v<T>,
-                    "Type of each tuple member must be default constructible");
-      *this >> const_cast<T &>(std::get<I>(v));  // NOLINT
+      static_assert(DecodableValue<T>,
+                    "Type of each tuple member must be default constructible "
+                    "or constructible from fields");
+      if constexpr (ConstructibleFromFields<T>) {
+        // member, which can not be decoded into, is replaced by decoded one
+        std::get<I>(v) = decodeValue<T>();
+      } else {
+        *this >> const_cast<T &>(std::get<I>(v));  // NOLINT
+      }
       if constexpr (sizeof...(Ts) > I + 1) {
         decodeElementOfTuple<I + 1>(v);
       }
@@ -471,12 +1108,21 @@ namespace scale {
       requires(I < sizeof...(Ts))
     void tryDecodeAsOneOfVariant(std::variant<Ts...> &v, size_t i) {
       using T = std::remove_cvref_t<std::tuple_element_t<I, std::tuple<Ts...>>>;
-      static_assert(std::is_default_constructible_v<T>,
-                    "All types of variant must be default constructible");
+      static_assert(DecodableValue<T>,
+                    "All types of variant must be default constructible or "
+                    "constructible from fields");
       if (I == i) {
-        T val{};
-        *this >> val;
-        v = std::forward<T>(val);
+        if constexpr (ConstructibleFromFields<T>) {
+          v.template emplace<I>(DecodedValue<T>{*this});
+        } else if (reusing_storage_ and v.index() == I) {
+          *this >> const_cast<T &>(std::get<I>(v));  // NOLINT
+        } else if (usingMemoryResource<T>()) {
+          v.template emplace<I>(DecodedValue<T>{*this});
+        } else {
+          T val{};
+          *this >> val;
+          v = std::forward<T>(val);
+        }
         return;
       }
       if constexpr (sizeof...(Ts) > I + 1) {
@@ -488,12 +1134,17 @@ namespace scale {
     template <size_t I, class... Ts>
     void tryDecodeAsOneOfVariant(boost::variant<Ts...> &v, size_t i) {
       using T = std::remove_cvref_t<std::tuple_element_t<I, std::tuple<Ts...>>>;
-      static_assert(std::is_default_constructible_v<T>,
-                    "All types of variant must be default constructible");
+      static_assert(DecodableValue<T>,
+                    "All types of variant must be default constructible or "
+                    "constructible from fields");
       if (I == i) {
-        T val;
-        *this >> val;
-        v = std::forward<T>(val);
+        if constexpr (ConstructibleFromFields<T>) {
+          v = decodeValue<T>();
+        } else {
+          T val{};
+          *this >> val;
+          v = std::forward<T>(val);
+        }
         return;
       }
       if constexpr (sizeof...(Ts) > I + 1) {
@@ -505,6 +1156,17 @@ namespace scale {
     ByteSpan span_;
 
     SizeType current_index_{0};
+
+    bool strict_ordering_ = false;
+
+    bool reusing_storage_ = false;
+
+    std::optional<size_t> allocation_budget_;
+
+    std::pmr::memory_resource *memory_resource_ = nullptr;
   };
 
+  extern template class BasicScaleDecoderStream<ScaleCompactCodec>;
+  extern template class BasicScaleDecoderStream<JamCompactCodec>;
+
 }  // namespace scale
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <concepts>
 #include <deque>
 #include <memory>
 #include <optional>
+#include <ranges>
 #include <string>
 #include <utility>
 #include <variant>
@@ -24,51 +28,57 @@
 #endif
 
 #include <scale/bitvec.hpp>
+#include <scale/bounded.hpp>
+#include <scale/columns.hpp>
+#include <scale/compact_codec.hpp>
 #include <scale/definitions.hpp>
 #include <scale/detail/aggregate.hpp>
 #include <scale/detail/fixed_width_integer.hpp>
-#ifdef JAM_COMPATIBILITY_ENABLED
-#include <scale/detail/jam_compact_integer.hpp>
-#else
-#include <scale/detail/compact_integer.hpp>
-#endif
+#include <scale/detail/key_order.hpp>
+#include <scale/detail/simd.hpp>
+#include <scale/flat_nested.hpp>
 #include <scale/configurable.hpp>
+#include <scale/memcpy_codable.hpp>
 #include <scale/scale_error.hpp>
 #include <scale/types.hpp>
 
 namespace scale {
 
   /**
-   * @class ScaleEncoderStream designed to scale-encode data to stream
+   * @class BasicScaleEncoderStream designed to scale-encode data to stream
+   * @tparam CompactCodec codec of compact integers, ScaleCompactCodec or
+   * JamCompactCodec
    */
-  class ScaleEncoderStream : public Configurable {
+  template <typename CompactCodec>
+  class BasicScaleEncoderStream : public Configurable {
    public:
     // special tag to differentiate encoding streams from others
     static constexpr auto is_encoder_stream = true;
 
-    ScaleEncoderStream();
+    BasicScaleEncoderStream();
 
     /**
      * Stream initialization
      * @param drop_data - when true will only count encoded data size while
      * omitting the data itself
      */
-    explicit ScaleEncoderStream(bool drop_data);
+    explicit BasicScaleEncoderStream(bool drop_data);
 
 #ifdef CUSTOM_CONFIG_ENABLED
-    explicit ScaleEncoderStream(const MaybeConfig auto &...configs)
+    explicit BasicScaleEncoderStream(const MaybeConfig auto &...configs)
         : Configurable(configs...) {}
 
-    explicit ScaleEncoderStream(bool drop_data,
-                                const MaybeConfig auto &...configs)
+    explicit BasicScaleEncoderStream(bool drop_data,
+                                     const MaybeConfig auto &...configs)
         : Configurable(configs...), drop_data_(drop_data) {}
 #else
     [[deprecated("Scale has compiled without custom config support")]]  //
-    explicit ScaleEncoderStream(const MaybeConfig auto &...configs) = delete;
+    explicit BasicScaleEncoderStream(
+        const MaybeConfig auto &...configs) = delete;
 
     [[deprecated("Scale has compiled without custom config support")]]  //
-    explicit ScaleEncoderStream(bool drop_data,
-                                const MaybeConfig auto &...configs) = delete;
+    explicit BasicScaleEncoderStream(
+        bool drop_data, const MaybeConfig auto &...configs) = delete;
 #endif
 
     /**
@@ -82,6 +92,13 @@ namespace scale {
      */
     [[nodiscard]] size_t size() const;
 
+    /**
+     * @brief puts a sequence of bytes to buffer at once
+     * @param v bytes to put
+     * @return reference to stream
+     */
+    BasicScaleEncoderStream &putBytes(ConstSpanOfBytes v);
+
     [[nodiscard]] auto begin() const {
       return stream_.begin();
     }
@@ -90,15 +107,22 @@ namespace scale {
     }
 
     /**
-     * @brief scale-encodes aggregate
+     * @brief scale-encodes aggregate, padding-free aggregate of
+     * memcpy-codable fields is put to stream at once
      * @param v aggregate to encode
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const SimpleCodeableAggregate auto &v)
+    BasicScaleEncoderStream &operator<<(const SimpleCodeableAggregate auto &v)
       requires(not qtils::is_tagged_v<decltype(v)>)
     {
+      static_assert(detail::encoder_fits_codec<CompactCodec, decltype(v)>,
+                    "operator<< of type is written for ScaleEncoderStream "
+                    "only, make it template of BasicScaleEncoderStream<C>");
+      if constexpr (MemcpyCodable<decltype(v)>) {
+        return putBytes({reinterpret_cast<const uint8_t *>(&v), sizeof(v)});
+      }
       return detail::decompose_and_apply(
-          v, [&](const auto &...args) -> ScaleEncoderStream & {
+          v, [&](const auto &...args) -> BasicScaleEncoderStream & {
             return (*this << ... << args);
           });
     }
@@ -108,11 +132,14 @@ namespace scale {
      * @param v object to encode
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const CustomDecomposable auto &v)
+    BasicScaleEncoderStream &operator<<(const CustomDecomposable auto &v)
       requires(not qtils::is_tagged_v<decltype(v)>)
     {
+      static_assert(detail::encoder_fits_codec<CompactCodec, decltype(v)>,
+                    "operator<< of type is written for ScaleEncoderStream "
+                    "only, make it template of BasicScaleEncoderStream<C>");
       return decompose_and_apply(
-          v, [&](const auto &...args) -> ScaleEncoderStream & {
+          v, [&](const auto &...args) -> BasicScaleEncoderStream & {
             return (*this << ... << args);
           });
     }
@@ -122,22 +149,128 @@ namespace scale {
      * @param collection range to encode
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const DynamicCollection auto &collection)
+    BasicScaleEncoderStream &operator<<(
+        const DynamicCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
+              and (not BoolVector<decltype(collection)>)
     {
       return encodeDynamicCollection(collection);
     }
 
-    ScaleEncoderStream &operator<<(const StaticCollection auto &collection)
+    BasicScaleEncoderStream &operator<<(const StaticCollection auto &collection)
       requires(not qtils::is_tagged_v<decltype(collection)>)
     {
       return encodeStaticCollection(collection);
     }
 
+    /**
+     * @brief scale-encodes vector of native compact integers in bulk
+     * @param collection vector to encode
+     * @return reference to stream
+     */
+    template <std::unsigned_integral T>
+      requires(sizeof(T) <= sizeof(uint64_t))
+    BasicScaleEncoderStream &operator<<(
+        const std::vector<Compact<T>> &collection) {
+      return encodeCompacts(collection | std::views::transform([](auto &item) {
+                              return static_cast<uint64_t>(untagged(item));
+                            }));
+    }
+
+    /**
+     * @brief scale-encodes range of native integers as vector of compact
+     * integers in bulk
+     * @param range range to encode
+     * @return reference to stream
+     */
+    template <std::unsigned_integral T>
+      requires(sizeof(T) <= sizeof(uint64_t))
+    BasicScaleEncoderStream &operator<<(const CompactRange<T> &range) {
+      return encodeCompacts(range.values);
+    }
+
     /**
      * @brief scale-encodes BitVec
      */
-    ScaleEncoderStream &operator<<(const BitVec &v);
+    BasicScaleEncoderStream &operator<<(const BitVec &v);
+
+    /**
+     * @brief scale-encodes PackedBitVec
+     */
+    BasicScaleEncoderStream &operator<<(const PackedBitVec &v);
+
+    /**
+     * @brief scale-encodes FlatNested as vector of vectors
+     * @param v sequence of sequences
+     * @return reference to stream
+     */
+    template <typename T>
+    BasicScaleEncoderStream &operator<<(const FlatNested<T> &v) {
+      *this << Length(v.size());
+      for (auto items : v.spans()) {
+        *this << Length(items.size());
+        putBytes(detail::asBytes(items));
+      }
+      return *this;
+    }
+
+    /**
+     * @brief scale-encodes ColumnsView as vector of rows. Rows of fixed width
+     * are transposed from columns by chunks on stack and put by chunks, so
+     * nothing is allocated.
+     * @param v view over columns
+     * @return reference to stream
+     */
+    template <typename... T>
+    BasicScaleEncoderStream &operator<<(const ColumnsView<T...> &v) {
+      using View = ColumnsView<T...>;
+      if (not v.consistent()) {
+        raise(EncodeError::INCONSISTENT_COLUMN_SIZES);
+      }
+      *this << Length(v.size());
+      if constexpr (View::kFixedWidth) {
+        if (drop_data_) {
+          bytes_written_ += v.size() * View::kRowSize;
+          return *this;
+        }
+        constexpr size_t kChunkRows =
+            std::max<size_t>(1, 4096 / View::kRowSize);
+        std::array<uint8_t, kChunkRows * View::kRowSize> chunk;
+        for (size_t first = 0; first < v.size(); first += kChunkRows) {
+          const auto count = std::min(kChunkRows, v.size() - first);
+          v.writeRows(first, count, chunk.data());
+          putBytes({chunk.data(), count * View::kRowSize});
+        }
+        return *this;
+      }
+      for (size_t i = 0; i < v.size(); ++i) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+          (*this << ... << v.template column<I>()[i]);
+        }(std::make_index_sequence<sizeof...(T)>{});
+      }
+      return *this;
+    }
+
+    /**
+     * @brief scale-encodes Columns as vector of aggregates, records of fixed
+     * width are encoded through ColumnsView
+     * @param v columns of records
+     * @return reference to stream
+     */
+    template <typename A>
+    BasicScaleEncoderStream &operator<<(const Columns<A> &v) {
+      using Records = Columns<A>;
+      if constexpr (Records::kFixedWidth) {
+        return *this << v.view();
+      }
+      *this << Length(v.size());
+      for (size_t i = 0; i < v.size(); ++i) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+          (*this << ... << v.template column<I>()[i]);
+        }(std::make_index_sequence<Records::kFieldCount>{});
+      }
+      return *this;
+    }
 
     /**
      * @brief scale-encodes pair of values
@@ -147,7 +280,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class F, class S>
-    ScaleEncoderStream &operator<<(const std::pair<F, S> &p) {
+    BasicScaleEncoderStream &operator<<(const std::pair<F, S> &p) {
       return *this << p.first << p.second;
     }
 
@@ -158,7 +291,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... Ts>
-    ScaleEncoderStream &operator<<(const std::tuple<Ts...> &v) {
+    BasicScaleEncoderStream &operator<<(const std::tuple<Ts...> &v) {
       if constexpr (sizeof...(Ts) > 0) {
         encodeElementOfTuple<0>(v);
       }
@@ -172,7 +305,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... T>
-    ScaleEncoderStream &operator<<(const std::variant<T...> &v) {
+    BasicScaleEncoderStream &operator<<(const std::variant<T...> &v) {
       tryEncodeAsOneOfVariant<0>(v);
       return *this;
     }
@@ -185,7 +318,7 @@ namespace scale {
      * @return reference to stream
      */
     template <class... T>
-    ScaleEncoderStream &operator<<(const boost::variant<T...> &v) {
+    BasicScaleEncoderStream &operator<<(const boost::variant<T...> &v) {
       tryEncodeAsOneOfVariant<0>(v);
       return *this;
     }
@@ -198,7 +331,7 @@ namespace scale {
      * @return reference to stream
      */
     template <typename T>
-    ScaleEncoderStream &operator<<(const std::shared_ptr<T> &v) {
+    BasicScaleEncoderStream &operator<<(const std::shared_ptr<T> &v) {
       if (v == nullptr) {
         raise(EncodeError::DEREF_NULLPOINTER);
       }
@@ -212,7 +345,7 @@ namespace scale {
      * @return reference to stream
      */
     template <typename T>
-    ScaleEncoderStream &operator<<(const std::unique_ptr<T> &v) {
+    BasicScaleEncoderStream &operator<<(const std::unique_ptr<T> &v) {
       if (v == nullptr) {
         raise(EncodeError::DEREF_NULLPOINTER);
       }
@@ -226,7 +359,7 @@ namespace scale {
      * @return reference to stream
      */
     template <typename T>
-    ScaleEncoderStream &operator<<(const std::optional<T> &v) {
+    BasicScaleEncoderStream &operator<<(const std::optional<T> &v) {
       // optional bool is a special case of optional values
       // it should be encoded using one byte instead of two
       // as described in specification
@@ -244,7 +377,7 @@ namespace scale {
      * @param v - std::nullopt only
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const std::nullopt_t &) {
+    BasicScaleEncoderStream &operator<<(const std::nullopt_t &) {
       return putByte(0u);
     }
 
@@ -255,7 +388,7 @@ namespace scale {
      * @return reference to stream;
      */
     template <typename T>
-    ScaleEncoderStream &operator<<(const std::reference_wrapper<T> &v) {
+    BasicScaleEncoderStream &operator<<(const std::reference_wrapper<T> &v) {
       return *this << static_cast<const T &>(v);
     }
 
@@ -264,19 +397,37 @@ namespace scale {
      * @param sv string_view item
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(std::string_view sv) {
+    BasicScaleEncoderStream &operator<<(std::string_view sv) {
       return encodeDynamicCollection(sv);
     }
 
     /**
-     * @brief scale-encodes a vector of bool
+     * @brief scale-encodes a vector of bool. Bits are gathered by bytes, which
+     * are expanded into chunk on stack and put by chunks, so nothing is
+     * allocated.
      * @param v vector of bool
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const std::vector<bool> &v) {
+    BasicScaleEncoderStream &operator<<(const BoolVector auto &v) {
+      checkBound(v);
       *this << Length(v.size());
-      for (bool el : v) {
-        *this << el;
+      if (drop_data_) {
+        bytes_written_ += v.size();
+        return *this;
+      }
+      constexpr size_t kChunkSize = 4096;
+      std::array<uint8_t, kChunkSize> chunk;
+      auto it = v.begin();
+      for (size_t first = 0; first < v.size(); first += kChunkSize) {
+        const auto count = std::min(kChunkSize, v.size() - first);
+        for (size_t i = 0; i < count; i += 8) {
+          uint8_t bits = 0;
+          for (size_t bit = 0; bit < 8 and i + bit < count; ++bit, ++it) {
+            bits |= static_cast<uint8_t>(*it ? 1u : 0u) << bit;
+          }
+          detail::expandBitsToBytes(bits, chunk.data() + i);
+        }
+        putBytes({chunk.data(), count});
       }
       return *this;
     }
@@ -289,7 +440,7 @@ namespace scale {
      */
     template <typename T>
       requires std::is_integral_v<std::remove_cvref_t<T>>
-    ScaleEncoderStream &operator<<(T &&v)
+    BasicScaleEncoderStream &operator<<(T &&v)
       requires(not qtils::is_tagged_v<decltype(v)>)
     {
       using I = std::decay_t<T>;
@@ -313,7 +464,7 @@ namespace scale {
      * @param v value of integral type
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(const BigFixedWidthInteger auto &v) {
+    BasicScaleEncoderStream &operator<<(const BigFixedWidthInteger auto &v) {
       constexpr auto bits =
           FixedWidthIntegerTraits<std::remove_cvref_t<decltype(v)>>::bits;
       for (size_t i = 0; i < bits; i += 8) {
@@ -327,16 +478,28 @@ namespace scale {
      * @param v value to encode
      * @return reference to stream
      */
-    ScaleEncoderStream &operator<<(CompactInteger auto &&v) {
+    BasicScaleEncoderStream &operator<<(CompactInteger auto &&v) {
       auto &&val = untagged(v);
-#ifdef JAM_COMPATIBILITY_ENABLED
-      detail::encodeJamCompactInteger(std::forward<decltype(val)>(val), *this);
-#else
-      detail::encodeCompactInteger(std::forward<decltype(val)>(val), *this);
-#endif
+      CompactCodec::encode(std::forward<decltype(val)>(val), *this);
       return *this;
     }
 
+    /**
+     * @brief enables encoding of unordered maps and sets in ascending order of
+     * keys, i.e. the same as ordered container of the same items is encoded.
+     * Otherwise they are encoded in order of iteration, which is not
+     * deterministic. Encoding of container whose keys have no operator< fails
+     * while it is enabled.
+     * @param deterministic true to sort items of unordered containers
+     */
+    void setDeterministicOrdering(bool deterministic) {
+      deterministic_ordering_ = deterministic;
+    }
+
+    bool isDeterministicOrdering() const {
+      return deterministic_ordering_;
+    }
+
    protected:
     template <size_t I, class... Ts>
     void encodeElementOfTuple(const std::tuple<Ts...> &v) {
@@ -373,13 +536,43 @@ namespace scale {
 #endif  // USE_BOOST_VARIANT
 
     /**
-     * @brief scale-encodes any dynamic collection
+     * @brief ensures that collection of limited count of items (BoundedVec,
+     * BoundedString) is within its bound, so it is encoded as decodable
+     * @param collection encoding collection
+     */
+    static void checkBound(const std::ranges::sized_range auto &collection) {
+      if constexpr (BoundedCollection<decltype(collection)>) {
+        if (std::ranges::size(collection)
+            > std::remove_cvref_t<decltype(collection)>::kMaxSize) {
+          raise(EncodeError::TOO_MANY_ITEMS);
+        }
+      }
+    }
+
+    /**
+     * @brief scale-encodes any dynamic collection, contiguous collection of
+     * memcpy-codable items is put to stream at once
      * @param collection encoding collection
      * @return reference to stream
      */
-    ScaleEncoderStream &encodeDynamicCollection(
+    BasicScaleEncoderStream &encodeDynamicCollection(
         const std::ranges::sized_range auto &collection) {
+      checkBound(collection);
       *this << Length(collection.size());
+      if constexpr (MemcpyCodableRange<decltype(collection)>
+                    or BoolContiguousRange<decltype(collection)>) {
+        return putBytes(detail::asBytes(collection));
+      } else if constexpr (UnorderedCollection<decltype(collection)>) {
+        if (deterministic_ordering_) {
+          using Key =
+              typename std::remove_cvref_t<decltype(collection)>::key_type;
+          if constexpr (std::totally_ordered<Key>) {
+            return encodeSortedByKey(collection);
+          } else {
+            raise(EncodeError::KEYS_NOT_ORDERED);
+          }
+        }
+      }
       for (const auto &item : collection) {
         *this << item;
       }
@@ -387,12 +580,49 @@ namespace scale {
     }
 
     /**
-     * @brief scale-encodes any static (fixed-size) collection
+     * @brief scale-encodes sized range of native integers as vector of compact
+     * integers: items are written into chunk on stack and put to stream by
+     * chunks, so nothing is allocated
+     * @param values integers to encode
+     * @return reference to stream
+     */
+    BasicScaleEncoderStream &encodeCompacts(
+        const std::ranges::sized_range auto &values) {
+      *this << Length(values.size());
+      if (drop_data_) {
+        for (uint64_t value : values) {
+          bytes_written_ += CompactCodec::lengthOf(value);
+        }
+        return *this;
+      }
+
+      // Each item is written by store of the widest form,
+      // so chunk has a room for it after the filled part
+      constexpr size_t kChunkSize = 4096;
+      std::array<uint8_t, kChunkSize + detail::kMaxNativeCompactSize> chunk;
+      size_t used = 0;
+      for (uint64_t value : values) {
+        used += CompactCodec::write(value, chunk.data() + used);
+        if (used >= kChunkSize) {
+          putBytes({chunk.data(), used});
+          used = 0;
+        }
+      }
+      return putBytes({chunk.data(), used});
+    }
+
+    /**
+     * @brief scale-encodes any static (fixed-size) collection, contiguous
+     * collection of memcpy-codable items is put to stream at once
      * @param collection encoding collection
      * @return reference to stream
      */
-    ScaleEncoderStream &encodeStaticCollection(
+    BasicScaleEncoderStream &encodeStaticCollection(
         const StaticCollection auto &collection) {
+      if constexpr (MemcpyCodableRange<decltype(collection)>
+                    or BoolContiguousRange<decltype(collection)>) {
+        return putBytes(detail::asBytes(collection));
+      }
       for (const auto &item : collection) {
         *this << item;
       }
@@ -404,29 +634,76 @@ namespace scale {
      * @param v byte value
      * @return reference to stream
      */
-    ScaleEncoderStream &putByte(uint8_t v);
+    BasicScaleEncoderStream &putByte(uint8_t v);
 
    private:
-    ScaleEncoderStream &encodeOptionalBool(const std::optional<bool> &v);
+    BasicScaleEncoderStream &encodeOptionalBool(const std::optional<bool> &v);
+
+    /**
+     * @brief encodes items of unordered map or set sorted by key. Items are
+     * sorted by pointers, without copying.
+     * @param collection encoding collection
+     * @return reference to stream
+     */
+    BasicScaleEncoderStream &encodeSortedByKey(
+        const UnorderedCollection auto &collection) {
+      using Collection = std::remove_cvref_t<decltype(collection)>;
+      using Item = typename Collection::value_type;
+      auto key_of = [](const void *item) -> const auto & {
+        if constexpr (requires { typename Collection::mapped_type; }) {
+          return static_cast<const Item *>(item)->first;
+        } else {
+          return *static_cast<const Item *>(item);
+        }
+      };
+
+      // scratch buffers are taken over, as items may contain unordered
+      // containers to be sorted as well
+      auto items = std::move(order_scratch_);
+      auto buffer = std::move(sort_scratch_);
+      items.clear();
+      for (const auto &item : collection) {
+        items.push_back(&item);
+      }
+      detail::sortByKey(items, buffer, key_of);
+      for (auto item : items) {
+        *this << *static_cast<const Item *>(item);
+      }
+      order_scratch_ = std::move(items);
+      sort_scratch_ = std::move(buffer);
+      return *this;
+    }
 
     const bool drop_data_ = false;
     std::deque<uint8_t> stream_;
     size_t bytes_written_ = 0;
+
+    bool deterministic_ordering_ = false;
+    std::vector<const void *> order_scratch_;
+    std::vector<const void *> sort_scratch_;
   };
 
   /**
    * @brief scale-encodes any enum type as its underlying type
-   * Defined outside ScaleEncoderStream to allow custom overloads for
+   * Defined outside BasicScaleEncoderStream to allow custom overloads for
    * specific enum types.
+   * @tparam C compact integer codec of stream
    * @tparam T enum type
    * @param v value of the enum type
    * @return reference to stream
    */
-  template <typename T>
+  template <typename C, typename T>
     requires std::is_enum_v<std::remove_cvref_t<T>>
-  ScaleEncoderStream &operator<<(ScaleEncoderStream &s, const T &v) {
+  BasicScaleEncoderStream<C> &operator<<(BasicScaleEncoderStream<C> &s,
+                                         const T &v) {
+    static_assert(detail::encoder_fits_codec<C, T>,
+                  "operator<< of enum is written for ScaleEncoderStream only, "
+                  "make it template of BasicScaleEncoderStream<C>");
     using E = std::decay_t<T>;
     return s << static_cast<std::underlying_type_t<E>>(v);
   }
 
+  extern template class BasicScaleEncoderStream<ScaleCompactCodec>;
+  extern template class BasicScaleEncoderStream<JamCompactCodec>;
+
 }  // namespace scale
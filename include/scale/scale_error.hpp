@@ -18,6 +18,9 @@ namespace scale {
     NEGATIVE_COMPACT_INTEGER,     ///< cannot compact-encode negative integers
     DEREF_NULLPOINTER,            ///< dereferencing a null pointer
     VALUE_TOO_BIG_FOR_COMPACT_REPRESENTATION,  ///< value too bit for compact representation
+    INCONSISTENT_COLUMN_SIZES,  ///< columns of view have different sizes
+    TOO_MANY_ITEMS,             ///< bounded collection exceeds its bound
+    KEYS_NOT_ORDERED,           ///< keys can not be sorted to encode
   };
 
   /**
@@ -31,6 +34,9 @@ namespace scale {
     INVALID_ENUM_VALUE,   ///< enum value which doesn't belong to the enum
     REDUNDANT_COMPACT_ENCODING,      ///< redundant bytes in compact encoding
     DECODED_VALUE_OVERFLOWS_TARGET,  ///< encoded value overflows target type
+    INVALID_UTF8,                    ///< string is not valid UTF-8
+    NOT_CANONICAL_ORDER,             ///< unsorted or duplicated keys
+    ALLOCATION_BUDGET_EXCEEDED,      ///< decoded values take too much memory
   };
 
 }  // namespace scale
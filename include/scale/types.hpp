@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <concepts>
 #include <cstdint>
 #include <ranges>
 #include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
@@ -18,8 +22,101 @@
 
 namespace scale {
 
-  class ScaleEncoderStream;
-  class ScaleDecoderStream;
+  struct ScaleCompactCodec;
+  struct JamCompactCodec;
+
+  /// @brief compact integer codec used by streams unless given explicitly
+#ifdef JAM_COMPATIBILITY_ENABLED
+  using DefaultCompactCodec = JamCompactCodec;
+#else
+  using DefaultCompactCodec = ScaleCompactCodec;
+#endif
+
+  template <typename CompactCodec = DefaultCompactCodec>
+  class BasicScaleEncoderStream;
+  template <typename CompactCodec = DefaultCompactCodec>
+  class BasicScaleDecoderStream;
+
+  using ScaleEncoderStream = BasicScaleEncoderStream<>;
+  using ScaleDecoderStream = BasicScaleDecoderStream<>;
+
+  /// @brief Concept of encoder stream with any compact integer codec
+  template <typename S>
+  concept EncoderStream = std::remove_cvref_t<S>::is_encoder_stream;
+
+  /// @brief Concept of decoder stream with any compact integer codec
+  template <typename S>
+  concept DecoderStream = std::remove_cvref_t<S>::is_decoder_stream;
+
+  namespace detail {
+    /// Argument which binds to stream of default compact codec only by
+    /// conversion, so just non-template overloads written for that concrete
+    /// stream type accept it, but not generic ones of library
+    struct DefaultEncoderStreamArg {
+      operator ScaleEncoderStream &() const;
+    };
+
+    /// @see DefaultEncoderStreamArg
+    struct DefaultDecoderStreamArg {
+      operator ScaleDecoderStream &() const;
+    };
+
+    /// @brief Concept of type with non-member encoding operator written for
+    /// stream of default compact codec
+    template <typename T>
+    concept HasDefaultStreamEncoder =
+        requires(const DefaultEncoderStreamArg &s, const T &v) {
+          operator<<(s, v);
+        };
+
+    /// @brief Concept of type with non-member decoding operator written for
+    /// stream of default compact codec
+    template <typename T>
+    concept HasDefaultStreamDecoder =
+        requires(const DefaultDecoderStreamArg &s, T &v) { operator>>(s, v); };
+
+    /// False if type has non-member encoding operator written for
+    /// ScaleEncoderStream only, but stream of other codec C encodes it, so
+    /// the operator would be silently bypassed by encoding of type structure
+    template <typename C, typename T>
+    constexpr bool encoder_fits_codec =
+        std::same_as<C, DefaultCompactCodec>
+        or not HasDefaultStreamEncoder<std::remove_cvref_t<T>>;
+
+    /// @see encoder_fits_codec
+    template <typename C, typename T>
+    constexpr bool decoder_fits_codec =
+        std::same_as<C, DefaultCompactCodec>
+        or not HasDefaultStreamDecoder<std::remove_cvref_t<T>>;
+  }  // namespace detail
+
+  /**
+   * @brief Concept of type with own non-member encoding operator (free or
+   * friend one), which takes precedence over encoding deduced from the type
+   * structure. For enums only non-template overloads are seen, because generic
+   * enum encoding is non-member template too.
+   */
+  template <typename T>
+  concept HasCustomEncoder =
+      detail::HasDefaultStreamEncoder<std::remove_cvref_t<T>>
+      or (not std::is_enum_v<std::remove_cvref_t<T>>
+          and requires(ScaleEncoderStream &s, const T &v) {
+                operator<<(s, v);
+              });
+
+  /// @brief Concept of type with own non-member decoding operator
+  /// @see HasCustomEncoder
+  template <typename T>
+  concept HasCustomDecoder =
+      detail::HasDefaultStreamDecoder<std::remove_cvref_t<T>>
+      or (not std::is_enum_v<std::remove_cvref_t<T>>
+          and requires(ScaleDecoderStream &s, std::remove_cvref_t<T> &v) {
+                operator>>(s, v);
+              });
+
+  /// @brief Concept of type with own non-member encoding or decoding operator
+  template <typename T>
+  concept HasCustomCodec = HasCustomEncoder<T> or HasCustomDecoder<T>;
 
   using uint128_t = boost::multiprecision::uint128_t;
   using uint256_t = boost::multiprecision::uint256_t;
@@ -38,6 +135,9 @@ namespace scale {
   namespace detail {
     struct CompactIntegerTag;
 
+    /// max size of native integer encoded as compact integer of any kind
+    constexpr static size_t kMaxNativeCompactSize = 1 + sizeof(uint64_t);
+
     template <typename Backend>
     constexpr bool is_unsigned_backend = not Backend().sign();
 
@@ -103,12 +203,14 @@ namespace scale {
     CompactReflection(CompactReflection &&) = delete;
     CompactReflection &operator=(CompactReflection &&) = delete;
 
-    friend ScaleEncoderStream &operator<<(ScaleEncoderStream &stream,
-                                          const CompactReflection &value) {
+    template <typename C>
+    friend BasicScaleEncoderStream<C> &operator<<(
+        BasicScaleEncoderStream<C> &stream, const CompactReflection &value) {
       return stream << Compact<std::remove_cvref_t<T>>(value.ref);
     }
-    friend ScaleDecoderStream &operator>>(ScaleDecoderStream &stream,
-                                          const CompactReflection &value) {
+    template <typename C>
+    friend BasicScaleDecoderStream<C> &operator>>(
+        BasicScaleDecoderStream<C> &stream, const CompactReflection &value) {
       Compact<std::remove_cvref_t<T>> tmp;
       stream >> tmp;
       value.ref = untagged(tmp);
@@ -127,6 +229,25 @@ namespace scale {
         std::forward<decltype(value)>(value));
   }
 
+  /// @brief Contiguous range of native integers, which is encoded as vector of
+  /// compact integers without making such vector
+  template <std::unsigned_integral T>
+  struct CompactRange {
+    std::span<const T> values;
+  };
+
+  template <std::unsigned_integral T>
+  CompactRange<T> as_compact_range(std::span<const T> values) {
+    return {values};
+  }
+
+  template <std::ranges::contiguous_range R>
+    requires std::unsigned_integral<std::ranges::range_value_t<R>>
+  auto as_compact_range(const R &values) {
+    return as_compact_range(
+        std::span<const std::ranges::range_value_t<R>>(values));
+  }
+
   /// @brief OptionalBool is internal extended bool type
   enum class OptionalBool : uint8_t {
     NONE = 0u,
@@ -228,6 +349,18 @@ namespace scale {
   concept ResizeableCollection = DynamicCollection<T>  //
                                  and HasResizeMethod<T>;
 
+  /// @brief Concept of std::vector<bool> or type derived from it
+  template <typename T>
+  concept BoolVector =
+      std::derived_from<std::remove_cvref_t<T>, std::vector<bool>>;
+
+  /// @brief Concept of collection with inline storage for first items, like
+  /// boost::container::small_vector and static_vector
+  template <typename T>
+  concept InlineCapacityCollection =
+      ResizeableCollection<T>
+      and requires { std::remove_cvref_t<T>::static_capacity; };
+
   template <typename T>
   concept ExtensibleBackCollection = DynamicCollection<T>         //
                                      and not(HasResizeMethod<T>)  //
@@ -237,6 +370,11 @@ namespace scale {
   concept RandomExtensibleCollection = DynamicCollection<T>  //
                                        and HasEmplaceMethod<T>;
 
+  template <typename T>
+  concept UnorderedCollection =
+      DynamicCollection<std::remove_cvref_t<T>>
+      and requires { typename std::remove_cvref_t<T>::hasher; };
+
   template <typename T>
   concept SimpleCodeableAggregate =
       std::is_aggregate_v<std::remove_cvref_t<T>>  //
@@ -258,4 +396,30 @@ namespace scale {
   concept CustomDecomposable =
       not SimpleCodeableAggregate<T> and HasDecomposeAndApply<T>::value;
 
+  namespace detail {
+    template <typename T>
+    struct is_pair_or_tuple : std::false_type {};
+
+    template <typename F, typename S>
+    struct is_pair_or_tuple<std::pair<F, S>> : std::true_type {};
+
+    template <typename... T>
+    struct is_pair_or_tuple<std::tuple<T...>> : std::true_type {};
+  }  // namespace detail
+
+  /// @brief Concept of type, which is not default constructible, so it is
+  /// decoded by construction from its decoded fields (in order of
+  /// decomposition, for custom decomposable type by its constructor)
+  template <typename T>
+  concept ConstructibleFromFields =
+      not std::is_default_constructible_v<std::remove_cvref_t<T>>
+      and (SimpleCodeableAggregate<T> or CustomDecomposable<T>
+           or detail::is_pair_or_tuple<std::remove_cvref_t<T>>::value);
+
+  /// @brief Concept of type, whose value can be decoded from scratch
+  template <typename T>
+  concept DecodableValue =
+      std::is_default_constructible_v<std::remove_cvref_t<T>>
+      or ConstructibleFromFields<T>;
+
 }  // namespace scale
@@ -0,0 +1,24 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+namespace scale {
+  /**
+   * @brief String compatible with rust `String`: encoded as std::string, but
+   * is validated to be UTF-8 while decoding
+   */
+  struct ValidatedUtf8String : std::string {
+    using std::string::string;
+
+    ValidatedUtf8String() = default;
+    explicit ValidatedUtf8String(std::string str)
+        : std::string(std::move(str)) {}
+  };
+}  // namespace scale
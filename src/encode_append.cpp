@@ -7,12 +7,6 @@
 #include <scale/encode_append.hpp>
 #include <scale/scale.hpp>
 
-#ifdef JAM_COMPATIBILITY_ENABLED
-#include <scale/detail/jam_compact_integer.hpp>
-#else
-#include <scale/detail/compact_integer.hpp>
-#endif
-
 namespace scale {
 
   /**
@@ -24,36 +18,38 @@ namespace scale {
    *  3. length of CompactInteger-scale-encoded length of EncodeOpaqueValues
    * vector after insertion there one more EncodeOpaqueValue
    */
+  template <typename CompactCodec>
   outcome::result<std::tuple<uint32_t, uint32_t, uint32_t>> extract_length_data(
       const std::vector<uint8_t> &data) {
-    OUTCOME_TRY(len, scale::decode<Compact<uint32_t>>(data));
+    BasicScaleDecoderStream<CompactCodec> s(data);
+    OUTCOME_TRY(len, scale::decode<Compact<uint32_t>>(s));
     auto new_len = len + 1;
-#ifdef JAM_COMPATIBILITY_ENABLED
-    auto encoded_len = detail::lengthOfEncodedJamCompactInteger(untagged(len));
-    auto encoded_new_len = detail::lengthOfEncodedJamCompactInteger(new_len);
-#else
-    auto encoded_len = detail::lengthOfEncodedCompactInteger(untagged(len));
-    auto encoded_new_len = detail::lengthOfEncodedCompactInteger(new_len);
-#endif
+    auto encoded_len = CompactCodec::lengthOf(untagged(len));
+    auto encoded_new_len = CompactCodec::lengthOf(new_len);
     return std::make_tuple(new_len, encoded_len, encoded_new_len);
   }
 
+  template <typename CompactCodec>
   outcome::result<void> append_or_new_vec(std::vector<uint8_t> &self_encoded,
                                           ConstSpanOfBytes input) {
     EncodeOpaqueValue opaque_value{.v = input};
 
     // No data present, just encode the given input data.
     if (self_encoded.empty()) {
-      self_encoded =
-          scale::encode(std::vector<EncodeOpaqueValue>{opaque_value}).value();
+      BasicScaleEncoderStream<CompactCodec> s;
+      s << std::vector<EncodeOpaqueValue>{opaque_value};
+      self_encoded = s.to_vector();
       return outcome::success();
     }
 
-    OUTCOME_TRY(extract_tuple, extract_length_data(self_encoded));
+    OUTCOME_TRY(extract_tuple,
+                extract_length_data<CompactCodec>(self_encoded));
     const auto &[new_len, encoded_len, encoded_new_len] = extract_tuple;
 
     auto replace_len = [new_len = new_len](std::vector<uint8_t> &dest) {
-      auto e = scale::encode(Length(new_len)).value();
+      BasicScaleEncoderStream<CompactCodec> s;
+      s << Length(new_len);
+      auto e = s.to_vector();
       std::move(e.begin(), e.end(), dest.begin());
     };
 
@@ -80,4 +76,10 @@ namespace scale {
         self_encoded.end(), opaque_value.v.begin(), opaque_value.v.end());
     return outcome::success();
   }
+
+  template outcome::result<void> append_or_new_vec<ScaleCompactCodec>(
+      std::vector<uint8_t> &self_encoded, ConstSpanOfBytes input);
+  template outcome::result<void> append_or_new_vec<JamCompactCodec>(
+      std::vector<uint8_t> &self_encoded, ConstSpanOfBytes input);
+
 }  // namespace scale
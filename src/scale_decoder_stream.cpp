@@ -7,7 +7,8 @@
 #include <scale/scale_decoder_stream.hpp>
 
 namespace scale {
-  std::optional<bool> ScaleDecoderStream::decodeOptionalBool() {
+  template <typename C>
+  std::optional<bool> BasicScaleDecoderStream<C>::decodeOptionalBool() {
     auto byte = nextByte();
     switch (static_cast<OptionalBool>(byte)) {
       case OptionalBool::NONE:
@@ -20,7 +21,8 @@ namespace scale {
     raise(DecodeError::UNEXPECTED_VALUE);
   }
 
-  bool ScaleDecoderStream::decodeBool() {
+  template <typename C>
+  bool BasicScaleDecoderStream<C>::decodeBool() {
     auto byte = nextByte();
     switch (byte) {
       case 0u:
@@ -32,33 +34,87 @@ namespace scale {
     }
   }
 
-  ScaleDecoderStream &ScaleDecoderStream::operator>>(BitVec &v) {
-    auto size = decodeCompact<size_t>();
-    if (not hasMore((size + 7) / 8)) {
-      raise(DecodeError::NOT_ENOUGH_DATA);
+  template <typename C>
+  ConstSpanOfBytes BasicScaleDecoderStream<C>::nextBoolBytes(size_t n) {
+    auto bytes = nextBytes(n);
+    if (detail::countLeadingBytesWithClearBits(bytes, 0xFE) != bytes.size()) {
+      raise(DecodeError::UNEXPECTED_VALUE);
     }
+    return bytes;
+  }
+
+  template <typename C>
+  BasicScaleDecoderStream<C> &BasicScaleDecoderStream<C>::operator>>(
+      BitVec &v) {
+    auto size = decodeCompact<size_t>();
+    auto bytes = nextBytes(size / 8 + (size % 8 != 0));
+    chargeAllocation(bytes.size(), 1);
     v.bits.resize(size);
     size_t i = 0;
-    uint8_t byte = 0;
     for (std::vector<bool>::reference bit : v.bits) {
-      if (i % 8 == 0) {
-        byte = nextByte();
-      }
-      bit = ((byte >> (i % 8)) & 1) != 0;
+      bit = ((bytes[i / 8] >> (i % 8)) & 1) != 0;
       ++i;
     }
 
     return *this;
   }
 
-  bool ScaleDecoderStream::hasMore(uint64_t n) const {
+  template <typename C>
+  BasicScaleDecoderStream<C> &BasicScaleDecoderStream<C>::operator>>(
+      PackedBitVec &v) {
+    auto size = decodeCompact<size_t>();
+    auto bytes = nextBytes(size / 8 + (size % 8 != 0));
+    chargeAllocation(size / PackedBitVec::kWordBits
+                         + (size % PackedBitVec::kWordBits != 0),
+                     sizeof(PackedBitVec::Word));
+    v.assign(size, bytes);
+    return *this;
+  }
+
+  template <typename C>
+  BasicScaleDecoderStream<C> &BasicScaleDecoderStream<C>::operator>>(
+      ValidatedUtf8String &v) {
+    auto size = decodeCompact<size_t>();
+    if (size > v.max_size()) {
+      raise(DecodeError::TOO_MANY_ITEMS);
+    }
+    auto bytes = nextBytes(size);
+    if (not detail::isValidUtf8(bytes)) {
+      raise(DecodeError::INVALID_UTF8);
+    }
+    chargeAllocation(size, 1);
+    try {
+      detail::assignFromBytes(v, bytes);
+    } catch (const std::bad_alloc &) {
+      raise(DecodeError::TOO_MANY_ITEMS);
+    }
+    return *this;
+  }
+
+  template <typename C>
+  bool BasicScaleDecoderStream<C>::hasMore(uint64_t n) const {
     return static_cast<size_t>(current_index_ + n) <= span_.size();
   }
 
-  uint8_t ScaleDecoderStream::nextByte() {
+  template <typename C>
+  uint8_t BasicScaleDecoderStream<C>::nextByte() {
     if (not hasMore(1)) {
       raise(DecodeError::NOT_ENOUGH_DATA);
     }
     return span_[current_index_++];
   }
+
+  template <typename C>
+  ConstSpanOfBytes BasicScaleDecoderStream<C>::nextBytes(size_t n) {
+    if (not hasMore(n)) {
+      raise(DecodeError::NOT_ENOUGH_DATA);
+    }
+    auto bytes = span_.subspan(current_index_, n);
+    current_index_ += n;
+    return bytes;
+  }
+
+  template class BasicScaleDecoderStream<ScaleCompactCodec>;
+  template class BasicScaleDecoderStream<JamCompactCodec>;
+
 }  // namespace scale
@@ -7,13 +7,16 @@
 #include <scale/scale_encoder_stream.hpp>
 
 namespace scale {
-  ScaleEncoderStream::ScaleEncoderStream()
+  template <typename C>
+  BasicScaleEncoderStream<C>::BasicScaleEncoderStream()
       : drop_data_{false}, bytes_written_{0} {}
 
-  ScaleEncoderStream::ScaleEncoderStream(bool drop_data)
+  template <typename C>
+  BasicScaleEncoderStream<C>::BasicScaleEncoderStream(bool drop_data)
       : drop_data_{drop_data}, bytes_written_{0} {}
 
-  ByteArray ScaleEncoderStream::to_vector() const {
+  template <typename C>
+  ByteArray BasicScaleEncoderStream<C>::to_vector() const {
     ByteArray buffer(stream_.size(), 0u);
     for (auto &&[it, dest] = std::pair(stream_.begin(), buffer.begin());
          it != stream_.end();
@@ -23,31 +26,65 @@ namespace scale {
     return buffer;
   }
 
-  size_t ScaleEncoderStream::size() const {
+  template <typename C>
+  size_t BasicScaleEncoderStream<C>::size() const {
     return bytes_written_;
   }
 
-  ScaleEncoderStream &ScaleEncoderStream::operator<<(const BitVec &v) {
+  template <typename C>
+  BasicScaleEncoderStream<C> &BasicScaleEncoderStream<C>::operator<<(
+      const BitVec &v) {
     *this << Length(v.bits.size());
-    size_t i = 0;
-    uint8_t byte = 0;
-    for (auto bit : v.bits) {
-      if (bit) {
-        byte |= 1 << (i % 8);
-      }
-      ++i;
-      if (i % 8 == 0) {
-        putByte(byte);
-        byte = 0;
+    const auto byte_count = (v.bits.size() + 7) / 8;
+    if (drop_data_) {
+      bytes_written_ += byte_count;
+      return *this;
+    }
+    // bits are packed into chunk on stack, which is put by chunks
+    constexpr size_t kChunkSize = 4096;
+    std::array<uint8_t, kChunkSize> chunk;
+    auto it = v.bits.begin();
+    for (size_t first = 0; first < byte_count; first += kChunkSize) {
+      const auto count = std::min(kChunkSize, byte_count - first);
+      for (size_t i = 0; i < count; ++i) {
+        uint8_t byte = 0;
+        for (size_t bit = 0; bit < 8 and it != v.bits.end(); ++bit, ++it) {
+          byte |= static_cast<uint8_t>(*it ? 1u : 0u) << bit;
+        }
+        chunk[i] = byte;
       }
+      putBytes({chunk.data(), count});
     }
-    if (i % 8 != 0) {
-      putByte(byte);
+    return *this;
+  }
+
+  template <typename C>
+  BasicScaleEncoderStream<C> &BasicScaleEncoderStream<C>::operator<<(
+      const PackedBitVec &v) {
+    *this << Length(v.size());
+    const auto byte_count = (v.size() + 7) / 8;
+    if constexpr (std::endian::native == std::endian::little) {
+      return putBytes(
+          {reinterpret_cast<const uint8_t *>(v.words().data()), byte_count});
+    }
+    // words are stored as little-endian into chunk on stack
+    constexpr size_t kChunkWords = 512;
+    constexpr size_t kWordSize = sizeof(PackedBitVec::Word);
+    std::array<uint8_t, kChunkWords * kWordSize> chunk;
+    for (size_t first = 0; first < v.words().size(); first += kChunkWords) {
+      const auto count = std::min(kChunkWords, v.words().size() - first);
+      for (size_t i = 0; i < count; ++i) {
+        boost::endian::store_little_u64(&chunk[i * kWordSize],
+                                        v.words()[first + i]);
+      }
+      putBytes({chunk.data(),
+                std::min(count * kWordSize, byte_count - first * kWordSize)});
     }
     return *this;
   }
 
-  ScaleEncoderStream &ScaleEncoderStream::putByte(uint8_t v) {
+  template <typename C>
+  BasicScaleEncoderStream<C> &BasicScaleEncoderStream<C>::putByte(uint8_t v) {
     ++bytes_written_;
     if (not drop_data_) {
       stream_.push_back(v);
@@ -55,7 +92,18 @@ namespace scale {
     return *this;
   }
 
-  ScaleEncoderStream &ScaleEncoderStream::encodeOptionalBool(
+  template <typename C>
+  BasicScaleEncoderStream<C> &BasicScaleEncoderStream<C>::putBytes(
+      ConstSpanOfBytes v) {
+    bytes_written_ += v.size();
+    if (not drop_data_) {
+      stream_.insert(stream_.end(), v.begin(), v.end());
+    }
+    return *this;
+  }
+
+  template <typename C>
+  BasicScaleEncoderStream<C> &BasicScaleEncoderStream<C>::encodeOptionalBool(
       const std::optional<bool> &v) {
     auto result = OptionalBool::OPT_TRUE;
 
@@ -68,4 +116,7 @@ namespace scale {
     return putByte(static_cast<uint8_t>(result));
   }
 
+  template class BasicScaleEncoderStream<ScaleCompactCodec>;
+  template class BasicScaleEncoderStream<JamCompactCodec>;
+
 }  // namespace scale
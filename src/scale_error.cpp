@@ -17,6 +17,12 @@ OUTCOME_CPP_DEFINE_CATEGORY(scale, EncodeError, e) {
       return "SCALE encode: compact integers too big";
     case EncodeError::DEREF_NULLPOINTER:
       return "SCALE encode: attempt to dereference a nullptr";
+    case EncodeError::INCONSISTENT_COLUMN_SIZES:
+      return "SCALE encode: columns of view have different sizes";
+    case EncodeError::TOO_MANY_ITEMS:
+      return "SCALE encode: bounded collection has more items than its bound";
+    case EncodeError::KEYS_NOT_ORDERED:
+      return "SCALE encode: keys of unordered collection can not be sorted";
   }
   return "unknown EncodeError";
 }
@@ -39,6 +45,12 @@ OUTCOME_CPP_DEFINE_CATEGORY(scale, DecodeError, e) {
       return "SCALE decode: redundant bytes in compact encoding";
     case DecodeError::DECODED_VALUE_OVERFLOWS_TARGET:
       return "SCALE decode: encoded value overflows target type";
+    case DecodeError::INVALID_UTF8:
+      return "SCALE decode: string is not valid UTF-8";
+    case DecodeError::NOT_CANONICAL_ORDER:
+      return "SCALE decode: keys of map or set are unsorted or duplicated";
+    case DecodeError::ALLOCATION_BUDGET_EXCEEDED:
+      return "SCALE decode: allocation budget of decoder is exhausted";
   }
   return "unknown SCALE DecodeError";
 }
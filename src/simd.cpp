@@ -0,0 +1,365 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <scale/detail/simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__)) \
+    and defined(__SSE2__)
+#include <immintrin.h>
+#define SCALE_SIMD_X86
+#endif
+
+namespace scale::detail {
+
+  namespace {
+
+    size_t countLeadingBytesWithClearBitsScalar(const uint8_t *data,
+                                                size_t size,
+                                                uint8_t bits) {
+      size_t i = 0;
+      while (i < size and (data[i] & bits) == 0) {
+        ++i;
+      }
+      return i;
+    }
+
+#ifdef SCALE_SIMD_X86
+
+    size_t countLeadingBytesWithClearBitsSse2(const uint8_t *data,
+                                              size_t size,
+                                              uint8_t bits) {
+      const auto mask = _mm_set1_epi8(static_cast<char>(bits));
+      const auto zero = _mm_setzero_si128();
+      size_t i = 0;
+      for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+        auto block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        auto clear = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_and_si128(block, mask), zero)));
+        if (clear != 0xFFFFu) {
+          return i + std::countr_one(clear);
+        }
+      }
+      return i + countLeadingBytesWithClearBitsScalar(data + i, size - i, bits);
+    }
+
+    __attribute__((target("avx2")))  //
+    size_t countLeadingBytesWithClearBitsAvx2(const uint8_t *data,
+                                              size_t size,
+                                              uint8_t bits) {
+      const auto mask = _mm256_set1_epi8(static_cast<char>(bits));
+      const auto zero = _mm256_setzero_si256();
+      size_t i = 0;
+      for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+        auto block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        auto clear = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_and_si256(block, mask), zero)));
+        if (clear != 0xFFFFFFFFu) {
+          return i + std::countr_one(clear);
+        }
+      }
+      return i + countLeadingBytesWithClearBitsSse2(data + i, size - i, bits);
+    }
+
+#endif  // SCALE_SIMD_X86
+
+
+    bool isValidUtf8Scalar(const uint8_t *data, size_t size) {
+      size_t i = 0;
+      while (i < size) {
+        i += countLeadingBytesWithClearBits({data + i, size - i}, 0x80);
+        if (i == size) {
+          break;
+        }
+        const uint8_t lead = data[i];
+        size_t length = 0;
+        // bounds of the second byte, which exclude overlong forms,
+        // surrogates and code points above U+10FFFF
+        uint8_t min = 0x80;
+        uint8_t max = 0xBF;
+        if (lead >= 0xC2 and lead <= 0xDF) {
+          length = 2;
+        } else if (lead >= 0xE0 and lead <= 0xEF) {
+          length = 3;
+          min = lead == 0xE0 ? 0xA0 : min;
+          max = lead == 0xED ? 0x9F : max;
+        } else if (lead >= 0xF0 and lead <= 0xF4) {
+          length = 4;
+          min = lead == 0xF0 ? 0x90 : min;
+          max = lead == 0xF4 ? 0x8F : max;
+        } else {
+          return false;
+        }
+        if (length > size - i) {
+          return false;
+        }
+        if (data[i + 1] < min or data[i + 1] > max) {
+          return false;
+        }
+        for (size_t k = 2; k < length; ++k) {
+          if ((data[i + k] & 0xC0) != 0x80) {
+            return false;
+          }
+        }
+        i += length;
+      }
+      return true;
+    }
+
+#ifdef SCALE_SIMD_X86
+
+    // Validation by lookup tables of high and low nibbles of each byte and
+    // high nibble of the next one, see: J. Keiser, D. Lemire, "Validating
+    // UTF-8 in less than one instruction per byte", 2021.
+    // Each bit of table item denotes one kind of error, which is detected when
+    // it is set in all three lookups for the pair of adjacent bytes.
+    constexpr uint8_t kTooShort = 1 << 0;
+    constexpr uint8_t kTooLong = 1 << 1;
+    constexpr uint8_t kOverlong3 = 1 << 2;
+    constexpr uint8_t kTooLarge = 1 << 3;
+    constexpr uint8_t kSurrogate = 1 << 4;
+    constexpr uint8_t kOverlong2 = 1 << 5;
+    constexpr uint8_t kTooLarge1000 = 1 << 6;
+    constexpr uint8_t kOverlong4 = 1 << 6;
+    constexpr uint8_t kTwoConts = 1 << 7;
+    constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+    constexpr std::array<uint8_t, 16> kByte1High{
+        // 0_______ : ASCII
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        kTooLong,
+        // 10______ : continuation
+        kTwoConts,
+        kTwoConts,
+        kTwoConts,
+        kTwoConts,
+        // 1100____ : two-byte lead
+        kTooShort | kOverlong2,
+        // 1101____ : two-byte lead
+        kTooShort,
+        // 1110____ : three-byte lead
+        kTooShort | kOverlong3 | kSurrogate,
+        // 1111____ : four-byte lead
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+    };
+
+    constexpr std::array<uint8_t, 16> kByte1Low{
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,    // ____0000
+        kCarry | kOverlong2,                              // ____0001
+        kCarry,                                           // ____0010
+        kCarry,                                           // ____0011
+        kCarry | kTooLarge,                               // ____0100
+        kCarry | kTooLarge | kTooLarge1000,               // ____0101
+        kCarry | kTooLarge | kTooLarge1000,               // ____0110
+        kCarry | kTooLarge | kTooLarge1000,               // ____0111
+        kCarry | kTooLarge | kTooLarge1000,               // ____1000
+        kCarry | kTooLarge | kTooLarge1000,               // ____1001
+        kCarry | kTooLarge | kTooLarge1000,               // ____1010
+        kCarry | kTooLarge | kTooLarge1000,               // ____1011
+        kCarry | kTooLarge | kTooLarge1000,               // ____1100
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,  // ____1101
+        kCarry | kTooLarge | kTooLarge1000,               // ____1110
+        kCarry | kTooLarge | kTooLarge1000,               // ____1111
+    };
+
+    constexpr std::array<uint8_t, 16> kByte2High{
+        // 0_______ : ASCII
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        // 1000____
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000
+            | kOverlong4,
+        // 1001____
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+        // 101_____
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        // 11______ : lead
+        kTooShort,
+        kTooShort,
+        kTooShort,
+        kTooShort,
+    };
+
+    __attribute__((target("avx2")))  //
+    __m256i lookup(const std::array<uint8_t, 16> &table, __m256i nibbles) {
+      auto half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&table));
+      return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(half), nibbles);
+    }
+
+    __attribute__((target("avx2")))  //
+    __m256i highNibbles(__m256i v) {
+      return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    /// bytes of input shifted by N positions, preceded by last ones of prev
+    template <int N>
+    __attribute__((target("avx2")))  //
+    __m256i previous(__m256i input, __m256i prev) {
+      return _mm256_alignr_epi8(
+          input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+    }
+
+    struct Utf8StateAvx2 {
+      __m256i error;
+      __m256i prev_input;
+      __m256i prev_incomplete;
+    };
+
+    __attribute__((target("avx2")))  //
+    void checkUtf8BlockAvx2(Utf8StateAvx2 &state, __m256i input) {
+      if (_mm256_movemask_epi8(input) == 0) {
+        // ASCII block is valid unless previous one is incomplete
+        state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+        state.prev_input = input;
+        return;
+      }
+      auto prev1 = previous<1>(input, state.prev_input);
+      auto low_nibbles = _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F));
+      auto byte_1_high = lookup(kByte1High, highNibbles(prev1));
+      auto byte_1_low = lookup(kByte1Low, low_nibbles);
+      auto byte_2_high = lookup(kByte2High, highNibbles(input));
+      auto special_cases = _mm256_and_si256(
+          _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      // third and fourth bytes of sequence must be continuations
+      auto third = _mm256_subs_epu8(previous<2>(input, state.prev_input),
+                                    _mm256_set1_epi8(0xE0 - 0x80));
+      auto fourth = _mm256_subs_epu8(previous<3>(input, state.prev_input),
+                                     _mm256_set1_epi8(0xF0 - 0x80));
+      auto must_be_continuation =
+          _mm256_and_si256(_mm256_or_si256(third, fourth),
+                           _mm256_set1_epi8(static_cast<char>(0x80)));
+      state.error = _mm256_or_si256(
+          state.error, _mm256_xor_si256(must_be_continuation, special_cases));
+
+      // only lead bytes at the end of block expect continuation in next one
+      const auto max_complete = _mm256_setr_epi8(
+          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+          static_cast<char>(0b11110000u - 1),
+          static_cast<char>(0b11100000u - 1),
+          static_cast<char>(0b11000000u - 1));
+      state.prev_incomplete = _mm256_subs_epu8(input, max_complete);
+      state.prev_input = input;
+    }
+
+    __attribute__((target("avx2")))  //
+    bool isValidUtf8Avx2(const uint8_t *data, size_t size) {
+      Utf8StateAvx2 state{
+          .error = _mm256_setzero_si256(),
+          .prev_input = _mm256_setzero_si256(),
+          .prev_incomplete = _mm256_setzero_si256(),
+      };
+      size_t i = 0;
+      for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+        checkUtf8BlockAvx2(
+            state,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+      }
+      if (i < size) {
+        std::array<uint8_t, sizeof(__m256i)> tail{};
+        std::copy(data + i, data + size, tail.begin());
+        checkUtf8BlockAvx2(
+            state,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&tail)));
+      }
+      auto error = _mm256_or_si256(state.error, state.prev_incomplete);
+      return _mm256_testz_si256(error, error) != 0;
+    }
+
+#endif  // SCALE_SIMD_X86
+
+
+    size_t countSetBitsScalar(const uint64_t *words, size_t size) {
+      size_t count = 0;
+      for (size_t i = 0; i < size; ++i) {
+        count += std::popcount(words[i]);
+      }
+      return count;
+    }
+
+#ifdef SCALE_SIMD_X86
+
+    __attribute__((target("popcnt")))  //
+    size_t countSetBitsPopcnt(const uint64_t *words, size_t size) {
+      size_t count = 0;
+      for (size_t i = 0; i < size; ++i) {
+        count += std::popcount(words[i]);
+      }
+      return count;
+    }
+
+#endif  // SCALE_SIMD_X86
+
+  }  // namespace
+
+  std::vector<SimdImpl<CountLeadingBytesWithClearBitsFn>>
+  countLeadingBytesWithClearBitsImpls() {
+    std::vector<SimdImpl<CountLeadingBytesWithClearBitsFn>> impls{
+        {"scalar", countLeadingBytesWithClearBitsScalar}};
+#ifdef SCALE_SIMD_X86
+    impls.push_back({"sse2", countLeadingBytesWithClearBitsSse2});
+    if (__builtin_cpu_supports("avx2")) {
+      impls.push_back({"avx2", countLeadingBytesWithClearBitsAvx2});
+    }
+#endif
+    return impls;
+  }
+
+  std::vector<SimdImpl<IsValidUtf8Fn>> isValidUtf8Impls() {
+    std::vector<SimdImpl<IsValidUtf8Fn>> impls{{"scalar", isValidUtf8Scalar}};
+#ifdef SCALE_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) {
+      impls.push_back({"avx2", isValidUtf8Avx2});
+    }
+#endif
+    return impls;
+  }
+
+  std::vector<SimdImpl<CountSetBitsFn>> countSetBitsImpls() {
+    std::vector<SimdImpl<CountSetBitsFn>> impls{{"scalar", countSetBitsScalar}};
+#ifdef SCALE_SIMD_X86
+    if (__builtin_cpu_supports("popcnt")) {
+      impls.push_back({"popcnt", countSetBitsPopcnt});
+    }
+#endif
+    return impls;
+  }
+
+  size_t countLeadingBytesWithClearBits(ConstSpanOfBytes bytes, uint8_t bits) {
+    static const auto impl = countLeadingBytesWithClearBitsImpls().back().fn;
+    return impl(bytes.data(), bytes.size(), bits);
+  }
+
+  bool isValidUtf8(ConstSpanOfBytes bytes) {
+    static const auto impl = isValidUtf8Impls().back().fn;
+    return impl(bytes.data(), bytes.size());
+  }
+
+  size_t countSetBits(std::span<const uint64_t> words) {
+    static const auto impl = countSetBitsImpls().back().fn;
+    return impl(words.data(), words.size());
+  }
+
+}  // namespace scale::detail
@@ -4,7 +4,23 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <bit>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+
+#include <boost/container/small_vector.hpp>
+#include <boost/container/static_vector.hpp>
 #include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+#include <scale/detail/simd.hpp>
 #include <scale/scale.hpp>
 
 using scale::BitVec;
@@ -13,7 +29,9 @@ using scale::CompactInteger;
 using scale::decode;
 using scale::DecodeError;
 using scale::encode;
+using scale::FlatNested;
 using scale::Length;
+using scale::PackedBitVec;
 using scale::ScaleDecoderStream;
 using scale::ScaleEncoderStream;
 
@@ -105,6 +123,159 @@ TEST(CollectionTest, encodeBitVec) {
   BitVec decoded;
   stream >> decoded;
   ASSERT_TRUE(std::ranges::equal(decoded.bits, collection.bits));
+
+  // crosses chunk of encoder, and is counted without encoding
+  BitVec long_collection{std::vector<bool>(40003)};
+  for (size_t i = 0; i < long_collection.bits.size(); i += 3) {
+    long_collection.bits[i] = true;
+  }
+  auto long_encoded = encode(long_collection).value();
+  ASSERT_EQ(long_encoded.size(), encodeLen(40003).size() + 5001);
+  ASSERT_EQ(long_encoded, encode(PackedBitVec{long_collection}).value());
+  ASSERT_EQ(decode<BitVec>(long_encoded).value(), long_collection);
+  ScaleEncoderStream counter(true);
+  counter << long_collection;
+  ASSERT_EQ(counter.size(), long_encoded.size());
+}
+
+/**
+ * @given long vector and array of bools, and encoding with a byte other than
+ * 0 or 1 after leading valid ones
+ * @when they are encoded and decoded
+ * @then values are restored, invalid byte is rejected
+ */
+TEST(CollectionTest, decodeBoolsInBulk) {
+  std::vector<bool> collection(100);
+  for (size_t i = 0; i < collection.size(); ++i) {
+    collection[i] = i % 5 == 1;
+  }
+  auto encoded = encode(collection).value();
+  ASSERT_EQ(decode<std::vector<bool>>(encoded).value(), collection);
+
+  std::array<bool, 40> array{};
+  array[3] = array[39] = true;
+  auto array_encoded = encode(array).value();
+  ASSERT_EQ(array_encoded.size(), array.size());
+  ASSERT_EQ(array_encoded[39], 1);
+  ASSERT_EQ((decode<std::array<bool, 40>>(array_encoded).value()), array);
+
+  // crosses chunk of encoder, has words of unset, set and mixed bits
+  std::mt19937 rand(42);
+  std::vector<bool> long_collection(10000);
+  for (size_t i = 0; i < long_collection.size(); ++i) {
+    long_collection[i] = i < 1000 ? rand() % 2 == 0 : i < 5000;
+  }
+  auto long_encoded = encode(long_collection).value();
+  ASSERT_EQ(long_encoded.size(), encodeLen(10000).size() + 10000);
+  ASSERT_EQ(decode<std::vector<bool>>(long_encoded).value(), long_collection);
+  ScaleEncoderStream counter(true);
+  counter << long_collection;
+  ASSERT_EQ(counter.size(), long_encoded.size());
+
+  encoded[70] = 2;
+  ASSERT_OUTCOME_ERROR(decode<std::vector<bool>>(encoded),
+                       DecodeError::UNEXPECTED_VALUE);
+  array_encoded[37] = 0x80;
+  ASSERT_OUTCOME_ERROR((decode<std::array<bool, 40>>(array_encoded)),
+                       DecodeError::UNEXPECTED_VALUE);
+}
+
+/**
+ * @given bits crossing boundary of 64-bit word
+ * @when PackedBitVec is encoded and decoded
+ * @then encoding is the same as of BitVec and bits are restored
+ */
+TEST(CollectionTest, encodePackedBitVec) {
+  std::vector<bool> bits(77);
+  for (size_t i = 0; i < bits.size(); ++i) {
+    bits[i] = i % 3 == 0 or i == 76;
+  }
+  PackedBitVec collection{bits};
+  ASSERT_EQ(collection.count(), 27);
+
+  auto encoded = encode(collection).value();
+  ASSERT_EQ(encoded, encode(BitVec{bits}).value());
+
+  auto decoded = decode<PackedBitVec>(encoded).value();
+  ASSERT_EQ(decoded, collection);
+  ASSERT_EQ(decoded.toBits(), bits);
+  ASSERT_EQ(decode<BitVec>(encoded).value().bits, bits);
+}
+
+/**
+ * @given encoded PackedBitVec with set padding bits of last byte
+ * @when it is decoded
+ * @then padding bits are ignored
+ */
+TEST(CollectionTest, decodePackedBitVecIgnoresPadding) {
+  auto encoded = encodeLen(3);
+  encoded.push_back(0b11111010);
+  auto decoded = decode<PackedBitVec>(encoded).value();
+  ASSERT_EQ(decoded.toBits(), (std::vector<bool>{false, true, false}));
+  ASSERT_EQ(decoded.count(), 1);
+  ASSERT_EQ(decoded, PackedBitVec(BitVec{{false, true, false}}));
+
+  encoded.pop_back();
+  ASSERT_OUTCOME_ERROR(decode<PackedBitVec>(encoded),
+                       DecodeError::NOT_ENOUGH_DATA);
+}
+
+/**
+ * @given two PackedBitVec of different sizes
+ * @when they are combined bitwise
+ * @then shorter one is treated as extended by unset bits
+ */
+TEST(CollectionTest, PackedBitVecBitwise) {
+  PackedBitVec a(100, true);
+  PackedBitVec b(70);
+  b.set(1);
+  b.set(69);
+
+  auto conjunction = a & b;
+  ASSERT_EQ(conjunction.size(), 100);
+  ASSERT_EQ(conjunction.count(), 2);
+  ASSERT_TRUE(conjunction.test(69));
+
+  auto disjunction = b | a;
+  ASSERT_EQ(disjunction.size(), 70);
+  ASSERT_EQ(disjunction.count(), 70);
+}
+
+/**
+ * @given random bytes and words of random lengths, and random bit masks
+ * @when they are scanned by each implementation of kernel available on CPU
+ * @then results match straightforward loops
+ */
+TEST(CollectionTest, SimdKernelsMatchReference) {
+  std::mt19937 rand(42);
+  for (size_t n = 0; n < 5000; ++n) {
+    std::vector<uint8_t> bytes(rand() % 200);
+    uint8_t bits = rand() % 2 == 0 ? 0x80 : static_cast<uint8_t>(rand());
+    for (auto &byte : bytes) {
+      // mostly bytes with clear bits, to get long leading runs
+      byte = rand() % 64 == 0 ? static_cast<uint8_t>(rand())
+                              : static_cast<uint8_t>(rand() & ~bits);
+    }
+    size_t leading = 0;
+    while (leading < bytes.size() and (bytes[leading] & bits) == 0) {
+      ++leading;
+    }
+    for (auto &impl : scale::detail::countLeadingBytesWithClearBitsImpls()) {
+      ASSERT_EQ(impl.fn(bytes.data(), bytes.size(), bits), leading)
+          << impl.isa << ' ' << n;
+    }
+
+    std::vector<uint64_t> words(rand() % 20);
+    size_t set_bits = 0;
+    for (auto &word : words) {
+      word = (uint64_t{rand()} << 32) | rand();
+      set_bits += std::popcount(word);
+    }
+    for (auto &impl : scale::detail::countSetBitsImpls()) {
+      ASSERT_EQ(impl.fn(words.data(), words.size()), set_bits)
+          << impl.isa << ' ' << n;
+    }
+  }
 }
 
 /**
@@ -351,6 +522,83 @@ TEST(CollectionTest, encodeVeryLongCollectionUint8) {
   ASSERT_EQ(stream.hasMore(1), false);
 }
 
+/**
+ * @given vector of vectors of bytes and of uint32_t
+ * @when they are decoded to FlatNested and encoded back
+ * @then inner sequences are restored, encoding is identical
+ */
+TEST(CollectionTest, FlatNestedRoundTrip) {
+  std::vector<std::vector<uint8_t>> bodies{{1, 2, 3}, {}, {4}, {5, 6}};
+  auto encoded = encode(bodies).value();
+  auto flat = decode<FlatNested<uint8_t>>(encoded).value();
+  ASSERT_EQ(flat.size(), bodies.size());
+  ASSERT_EQ(flat.values().size(), 6);
+  ASSERT_TRUE(std::ranges::equal(flat.offsets(),
+                                 std::vector<size_t>{0, 3, 3, 4, 6}));
+  size_t i = 0;
+  for (auto items : flat.spans()) {
+    ASSERT_TRUE(std::ranges::equal(items, bodies[i++]));
+  }
+  ASSERT_EQ(encode(flat).value(), encoded);
+
+  std::vector<std::vector<uint32_t>> words{{0xDEADBEEF}, {1, 2}};
+  encoded = encode(words).value();
+  auto flat_words = decode<FlatNested<uint32_t>>(encoded).value();
+  ASSERT_TRUE(std::ranges::equal(flat_words[1], words[1]));
+  ASSERT_EQ(encode(flat_words).value(), encoded);
+
+  // moved-from object is empty and usable
+  auto moved = std::move(flat_words);
+  ASSERT_EQ(moved.size(), words.size());
+  ASSERT_TRUE(flat_words.empty());  // NOLINT(bugprone-use-after-move)
+  ASSERT_EQ(flat_words, FlatNested<uint32_t>{});
+  ASSERT_EQ(encode(flat_words).value(), encode(ByteArray{}).value());
+  flat_words.push_back(words[1]);
+  ASSERT_TRUE(std::ranges::equal(flat_words[0], words[1]));
+
+  encoded.pop_back();
+  ASSERT_OUTCOME_ERROR(decode<FlatNested<uint32_t>>(encoded),
+                       DecodeError::NOT_ENOUGH_DATA);
+}
+
+/**
+ * @given encoded vectors of memcpy-codable items, of bools and of strings
+ * @when they are decoded to small_vector and static_vector
+ * @then items are restored, input exceeding capacity of static_vector is
+ * rejected before resize
+ */
+TEST(CollectionTest, decodeInlineCapacityVectors) {
+  using boost::container::small_vector;
+  using boost::container::static_vector;
+  static_assert(scale::InlineCapacityCollection<small_vector<uint32_t, 4>>);
+  static_assert(scale::InlineCapacityCollection<static_vector<uint32_t, 3>>);
+
+  auto encoded = encode(std::vector<uint32_t>{1, 2, 3}).value();
+  auto small = decode<small_vector<uint32_t, 4>>(encoded).value();
+  ASSERT_EQ(small, (small_vector<uint32_t, 4>{1, 2, 3}));
+  auto fixed = decode<static_vector<uint32_t, 3>>(encoded).value();
+  ASSERT_EQ(fixed, (static_vector<uint32_t, 3>{1, 2, 3}));
+  ASSERT_OUTCOME_ERROR((decode<static_vector<uint32_t, 2>>(encoded)),
+                       DecodeError::TOO_MANY_ITEMS);
+
+  auto long_encoded = encode(std::vector<uint16_t>(10, 7)).value();
+  ASSERT_EQ((decode<small_vector<uint16_t, 2>>(long_encoded).value()),
+            (small_vector<uint16_t, 2>(10, 7)));
+
+  auto flags = encode(std::vector<bool>{true, false, true}).value();
+  ASSERT_EQ((decode<small_vector<bool, 4>>(flags).value()),
+            (small_vector<bool, 4>{true, false, true}));
+  flags.back() = 2;
+  ASSERT_OUTCOME_ERROR((decode<small_vector<bool, 4>>(flags)),
+                       DecodeError::UNEXPECTED_VALUE);
+
+  auto names = encode(std::vector<std::string>{"a", "bc"}).value();
+  ASSERT_EQ((decode<static_vector<std::string, 2>>(names).value()),
+            (static_vector<std::string, 2>{"a", "bc"}));
+  ASSERT_OUTCOME_ERROR((decode<static_vector<std::string, 1>>(names)),
+                       DecodeError::TOO_MANY_ITEMS);
+}
+
 /**
  * @given map of <uint32_t, uint32_t>
  * @when encodeCollection is applied
@@ -370,6 +618,114 @@ TEST(CollectionTest, encodeMapTest) {
       decoded.begin(), decoded.end(), collection.begin(), collection.end()));
 }
 
+/**
+ * @given encoded keys in ascending, unsorted and duplicated order
+ * @when they are decoded to sets and maps with and without strict ordering
+ * @then non-canonical order is accepted by default and rejected in strict mode
+ */
+TEST(CollectionTest, decodeMapCanonicalOrder) {
+  auto sorted = encode(std::vector<uint32_t>{1, 2, 3}).value();
+  auto unsorted = encode(std::vector<uint32_t>{3, 1, 2}).value();
+  auto duplicated = encode(std::vector<uint32_t>{1, 2, 2}).value();
+
+  auto decode_set = [](const ByteArray &bytes, bool strict) {
+    ScaleDecoderStream stream(bytes);
+    stream.setStrictOrdering(strict);
+    std::set<uint32_t> set;
+    stream >> set;
+    return set;
+  };
+  ASSERT_EQ(decode_set(sorted, true), (std::set<uint32_t>{1, 2, 3}));
+  ASSERT_EQ(decode_set(unsorted, false), (std::set<uint32_t>{1, 2, 3}));
+  ASSERT_EQ(decode_set(duplicated, false), (std::set<uint32_t>{1, 2}));
+  EXPECT_THROW(decode_set(unsorted, true), std::system_error);
+  EXPECT_THROW(decode_set(duplicated, true), std::system_error);
+
+  std::vector<std::pair<uint32_t, uint32_t>> pairs{{1, 5}, {4, 8}, {1, 6}};
+  auto encoded = encode(pairs).value();
+  auto decode_map = [&](auto map, bool strict) {
+    ScaleDecoderStream stream(encoded);
+    stream.setStrictOrdering(strict);
+    stream >> map;
+    return map;
+  };
+  ASSERT_EQ(decode_map(std::unordered_map<uint32_t, uint32_t>{}, false),
+            (std::unordered_map<uint32_t, uint32_t>{{1, 5}, {4, 8}}));
+  EXPECT_THROW(decode_map(std::unordered_map<uint32_t, uint32_t>{}, true),
+               std::system_error);
+
+  EXPECT_THROW(decode_map(std::map<uint32_t, uint32_t>{}, true),
+               std::system_error);
+
+  pairs.pop_back();
+  encoded = encode(pairs).value();
+  ASSERT_EQ(decode_map(std::map<uint32_t, uint32_t>{}, true),
+            (std::map<uint32_t, uint32_t>{{1, 5}, {4, 8}}));
+}
+
+/**
+ * @given unordered maps and sets with integer, byte array and string keys
+ * @when they are encoded with deterministic ordering
+ * @then encoding is the same as of ordered containers of the same items
+ */
+TEST(CollectionTest, encodeUnorderedDeterministically) {
+  auto encode_sorted = [](const auto &collection) {
+    ScaleEncoderStream s;
+    s.setDeterministicOrdering(true);
+    s << collection;
+    return s.to_vector();
+  };
+
+  // long enough to be sorted by radix sort
+  std::unordered_map<int32_t, uint8_t> ints;
+  for (int32_t i = -100; i < 100; ++i) {
+    ints.emplace(i * 7919, static_cast<uint8_t>(i));
+  }
+  ASSERT_EQ(encode_sorted(ints),
+            encode(std::map(ints.begin(), ints.end())).value());
+
+  struct KeyHash {
+    size_t operator()(const std::array<uint8_t, 2> &key) const {
+      return key[0] * 256 + key[1];
+    }
+  };
+  std::unordered_set<std::array<uint8_t, 2>, KeyHash> keys;
+  for (size_t i = 0; i < 300; ++i) {
+    keys.insert({static_cast<uint8_t>(i * 31), static_cast<uint8_t>(i / 3)});
+  }
+  ASSERT_EQ(encode_sorted(keys),
+            encode(std::set(keys.begin(), keys.end())).value());
+
+  std::unordered_map<std::string, std::unordered_set<uint16_t>> nested{
+      {"b", {3, 1, 2}}, {"a", {}}, {"c", {9, 8}}};
+  std::map<std::string, std::set<uint16_t>> ordered{
+      {"b", {1, 2, 3}}, {"a", {}}, {"c", {8, 9}}};
+  ASSERT_EQ(encode_sorted(nested), encode(ordered).value());
+}
+
+/**
+ * @given unordered map whose keys have only equality and hash, no order
+ * @when it is encoded with and without deterministic ordering
+ * @then it is encoded in order of iteration, and fails to be sorted
+ */
+TEST(CollectionTest, encodeUnorderedWithoutKeyOrder) {
+  struct Key {
+    uint8_t value;
+    bool operator==(const Key &) const = default;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      return key.value;
+    }
+  };
+  std::unordered_map<Key, uint8_t, KeyHash> map{{{1}, 2}};
+  ASSERT_EQ(encode(map).value(), (ByteArray{4, 1, 2}));
+
+  ScaleEncoderStream s;
+  s.setDeterministicOrdering(true);
+  ASSERT_THROW(s << map, std::system_error);
+}
+
 template <template <typename...> class BaseContainer,
           size_t WithMaxSize,
           typename... Args>
@@ -428,6 +784,319 @@ TEST(CollectionTest, decodeSizeLimitedCollection) {
   }
 }
 
+struct BoundedRecord {
+  scale::BoundedVec<uint32_t, 3> values;
+  scale::BoundedString<4> name;
+  scale::BoundedVec<bool, 2> flags;
+
+  bool operator==(const BoundedRecord &) const = default;
+};
+
+/**
+ * @given encoded collections within and beyond bounds, and length prefix of
+ * a billion items followed by nothing
+ * @when they are decoded to BoundedVec and BoundedString
+ * @then bounded values are restored, oversized ones are rejected by
+ * TOO_MANY_ITEMS right after the length
+ */
+TEST(CollectionTest, decodeBounded) {
+  using scale::BoundedString;
+  using scale::BoundedVec;
+
+  BoundedRecord record{{1, 2, 3}, BoundedString<4>{"name"}, {true, false}};
+  auto encoded = encode(record).value();
+  ASSERT_EQ(encoded,
+            encode(std::tuple(std::vector<uint32_t>{1, 2, 3},
+                              std::string{"name"},
+                              std::vector<bool>{true, false}))
+                .value());
+  ASSERT_EQ(decode<BoundedRecord>(encoded).value(), record);
+
+  auto four = encode(std::vector<uint32_t>{1, 2, 3, 4}).value();
+  ASSERT_OUTCOME_ERROR((decode<BoundedVec<uint32_t, 3>>(four)),
+                       DecodeError::TOO_MANY_ITEMS);
+  auto strings = encode(std::vector<std::string>{"a", "b", "c"}).value();
+  ASSERT_OUTCOME_ERROR((decode<BoundedVec<std::string, 2>>(strings)),
+                       DecodeError::TOO_MANY_ITEMS);
+  auto flags = encode(std::vector<bool>{true, true, true}).value();
+  ASSERT_OUTCOME_ERROR((decode<BoundedVec<bool, 2>>(flags)),
+                       DecodeError::TOO_MANY_ITEMS);
+  ASSERT_OUTCOME_ERROR(decode<BoundedString<4>>(encode("names").value()),
+                       DecodeError::TOO_MANY_ITEMS);
+
+  auto billion = encodeLen(1'000'000'000);
+  ASSERT_OUTCOME_ERROR((decode<BoundedVec<std::string, 16>>(billion)),
+                       DecodeError::TOO_MANY_ITEMS);
+}
+
+/**
+ * @given bounded collections holding more items than their bound
+ * @when they are encoded
+ * @then encoding fails with TOO_MANY_ITEMS, as such data is not decodable
+ */
+TEST(CollectionTest, encodeBeyondBound) {
+  using scale::BoundedString;
+  using scale::BoundedVec;
+  using scale::EncodeError;
+
+  BoundedVec<uint32_t, 3> values{1, 2, 3};
+  ASSERT_OUTCOME_SUCCESS(encode(values));
+  values.push_back(4);
+  ASSERT_OUTCOME_ERROR(encode(values), EncodeError::TOO_MANY_ITEMS);
+
+  BoundedVec<std::string, 1> strings{"a", "b"};
+  ASSERT_OUTCOME_ERROR(encode(strings), EncodeError::TOO_MANY_ITEMS);
+  BoundedVec<bool, 2> flags{true, true, true};
+  ASSERT_OUTCOME_ERROR(encode(flags), EncodeError::TOO_MANY_ITEMS);
+  ASSERT_OUTCOME_ERROR(encode(BoundedString<4>{"names"}),
+                       EncodeError::TOO_MANY_ITEMS);
+
+  BoundedRecord record{{1, 2, 3}, BoundedString<4>{"name"}, {true, false}};
+  record.name += '!';
+  ASSERT_OUTCOME_ERROR(encode(record), EncodeError::TOO_MANY_ITEMS);
+}
+
+struct Sample {
+  uint32_t id;
+  std::string name;
+  std::optional<uint16_t> tag;
+
+  bool operator==(const Sample &) const = default;
+};
+
+/**
+ * @given length prefixes of more items than remaining data could hold
+ * @when they are decoded to collections of items of various least sizes
+ * @then NOT_ENOUGH_DATA is raised before room for items is allocated
+ */
+TEST(CollectionTest, decodeCountBeyondRemainingData) {
+  using scale::min_encoded_size_v;
+  static_assert(min_encoded_size_v<std::string> == 1);
+  static_assert(min_encoded_size_v<std::pair<uint32_t, uint64_t>> == 12);
+  static_assert(min_encoded_size_v<std::variant<uint8_t, uint64_t>> == 2);
+  static_assert(min_encoded_size_v<std::array<uint16_t, 3>> == 6);
+  static_assert(min_encoded_size_v<Sample> == 6);
+
+  auto billion = encodeLen(1'000'000'000);
+  ASSERT_OUTCOME_ERROR(decode<std::vector<std::string>>(billion),
+                       DecodeError::NOT_ENOUGH_DATA);
+  ASSERT_OUTCOME_ERROR(decode<std::list<std::string>>(billion),
+                       DecodeError::NOT_ENOUGH_DATA);
+  ASSERT_OUTCOME_ERROR((decode<std::map<uint32_t, std::string>>(billion)),
+                       DecodeError::NOT_ENOUGH_DATA);
+  ASSERT_OUTCOME_ERROR(decode<scale::Columns<Sample>>(billion),
+                       DecodeError::NOT_ENOUGH_DATA);
+
+  // two samples take 12 bytes at least
+  auto samples = encodeLen(2);
+  samples.resize(samples.size() + 11);
+  ASSERT_OUTCOME_ERROR(decode<std::vector<Sample>>(samples),
+                       DecodeError::NOT_ENOUGH_DATA);
+
+  std::vector<Sample> values{{1, "one", std::nullopt}, {2, "two", 2}};
+  ASSERT_EQ(decode<std::vector<Sample>>(encode(values).value()).value(),
+            values);
+}
+
+/// Enum of wide underlying type, which encodes itself by one byte
+enum class Level : uint32_t { LOW, HIGH };
+
+ScaleEncoderStream &operator<<(ScaleEncoderStream &s, const Level &v) {
+  return s << static_cast<uint8_t>(v);
+}
+
+ScaleDecoderStream &operator>>(ScaleDecoderStream &s, Level &v) {
+  uint8_t byte;
+  s >> byte;
+  v = static_cast<Level>(byte);
+  return s;
+}
+
+/// Enum of wide underlying type, which encodes itself by one byte for
+/// streams of any codec
+enum class Grade : uint32_t { LOW, HIGH };
+
+template <typename C>
+scale::BasicScaleEncoderStream<C> &operator<<(
+    scale::BasicScaleEncoderStream<C> &s, const Grade &v) {
+  return s << static_cast<uint8_t>(v);
+}
+
+template <typename C>
+scale::BasicScaleDecoderStream<C> &operator>>(
+    scale::BasicScaleDecoderStream<C> &s, Grade &v) {
+  uint8_t byte;
+  s >> byte;
+  v = static_cast<Grade>(byte);
+  return s;
+}
+
+/// Aggregate of wide field, which encodes itself as compact integer
+struct Stamp {
+  uint64_t value;
+
+  bool operator==(const Stamp &) const = default;
+
+  friend ScaleEncoderStream &operator<<(ScaleEncoderStream &s,
+                                        const Stamp &v) {
+    return s << scale::as_compact(v.value);
+  }
+
+  friend ScaleDecoderStream &operator>>(ScaleDecoderStream &s, Stamp &v) {
+    return s >> scale::as_compact(v.value);
+  }
+};
+
+/**
+ * @given collections of enums (with plain and templated codecs) and aggregates
+ * with own codec, whose items are encoded by fewer bytes than their
+ * underlying type or fields take
+ * @when they are decoded
+ * @then least encoded size of items is unknown, so valid data is accepted
+ */
+TEST(CollectionTest, decodeCountOfItemsWithCustomCodec) {
+  using scale::min_encoded_size_v;
+  static_assert(min_encoded_size_v<Level> == 0);
+  static_assert(min_encoded_size_v<Grade> == 0);
+  static_assert(min_encoded_size_v<Stamp> == 0);
+
+  std::vector<Level> levels{Level::HIGH, Level::LOW, Level::HIGH};
+  auto encoded_levels = encode(levels).value();
+  ASSERT_EQ(encoded_levels.size(), 1 + levels.size());
+  ASSERT_OUTCOME_SUCCESS(decoded_levels,
+                         decode<std::vector<Level>>(encoded_levels));
+  ASSERT_EQ(decoded_levels, levels);
+
+  std::vector<Grade> grades{Grade::HIGH, Grade::LOW, Grade::HIGH};
+  auto encoded_grades = encode(grades).value();
+  ASSERT_EQ(encoded_grades.size(), 1 + grades.size());
+  ASSERT_OUTCOME_SUCCESS(decoded_grades,
+                         decode<std::vector<Grade>>(encoded_grades));
+  ASSERT_EQ(decoded_grades, grades);
+
+  std::vector<Stamp> stamps{{1}, {64}, {1ull << 40}};
+  ASSERT_OUTCOME_SUCCESS(decoded_stamps,
+                         decode<std::vector<Stamp>>(encode(stamps).value()));
+  ASSERT_EQ(decoded_stamps, stamps);
+}
+
+/**
+ * @given nested vectors, whose items take 200 bytes of memory in total
+ * @when they are decoded with allocation budget below and above that
+ * @then decoding fails with ALLOCATION_BUDGET_EXCEEDED or succeeds and the
+ * rest of budget remains
+ */
+TEST(CollectionTest, decodeWithAllocationBudget) {
+  using Nested = std::vector<std::vector<uint32_t>>;
+  Nested nested(4, std::vector<uint32_t>(11));
+  auto encoded = encode(nested).value();
+  const size_t total =
+      4 * sizeof(std::vector<uint32_t>) + 4 * 11 * sizeof(uint32_t);
+
+  ScaleDecoderStream s(encoded);
+  ASSERT_EQ(s.allocationBudget(), std::nullopt);
+  s.setAllocationBudget(total - 1);
+  Nested decoded;
+  try {
+    s >> decoded;
+    FAIL() << "Exception expected";
+  } catch (std::system_error &e) {
+    EXPECT_EQ(e.code(), DecodeError::ALLOCATION_BUDGET_EXCEEDED);
+  }
+
+  ScaleDecoderStream t(encoded);
+  t.setAllocationBudget(total + 10);
+  ASSERT_NO_THROW(t >> decoded);
+  ASSERT_EQ(decoded, nested);
+  ASSERT_EQ(t.allocationBudget(), 10);
+
+  auto pointer = encode(uint64_t{7}).value();
+  ScaleDecoderStream u(pointer);
+  u.setAllocationBudget(sizeof(uint64_t) - 1);
+  std::unique_ptr<uint64_t> value;
+  EXPECT_THROW(u >> value, std::system_error);
+}
+
+/**
+ * @given encoded sequences of integers, bools and strings
+ * @when they are decoded into preallocated buffers
+ * @then items fill beginning of buffer and their count is returned, sequence
+ * longer than buffer is rejected
+ */
+TEST(CollectionTest, decodeIntoBuffer) {
+  using scale::decode_into;
+
+  std::vector<uint32_t> values{1, 2, 3};
+  std::array<uint32_t, 4> buffer{};
+  auto encoded = encode(values).value();
+  ScaleDecoderStream s(encoded);
+  ASSERT_EQ(decode_into(s, std::span(buffer)).value(), 3);
+  ASSERT_EQ(buffer, (std::array<uint32_t, 4>{1, 2, 3, 0}));
+
+  std::array<bool, 3> flags{};
+  auto encoded_flags = encode(std::vector<bool>{false, true}).value();
+  ScaleDecoderStream t(encoded_flags);
+  ASSERT_EQ(decode_into(t, std::span(flags)).value(), 2);
+  ASSERT_TRUE(flags[1]);
+
+  std::vector<std::string> names(2);
+  auto encoded_names = encode(std::vector<std::string>{"a", "bc"}).value();
+  ScaleDecoderStream u(encoded_names);
+  ASSERT_EQ(decode_into(u, std::span(names)).value(), 2);
+  ASSERT_EQ(names, (std::vector<std::string>{"a", "bc"}));
+
+  std::array<uint32_t, 2> small{};
+  ScaleDecoderStream v(encoded);
+  ASSERT_OUTCOME_ERROR(decode_into(v, std::span(small)),
+                       DecodeError::TOO_MANY_ITEMS);
+}
+
+struct Message {
+  std::vector<std::string> names;
+  std::optional<std::vector<uint8_t>> payload;
+  std::unique_ptr<std::string> note;
+  std::variant<uint32_t, std::string> tag;
+};
+
+/**
+ * @given long-lived message and encodings of similar shorter messages
+ * @when they are decoded into it with storage reusing
+ * @then values are restored and buffers of previous values are reused
+ */
+TEST(CollectionTest, decodeReusingStorage) {
+  auto make = [](size_t n) {
+    Message m;
+    for (size_t i = 0; i < n; ++i) {
+      m.names.push_back(std::string(20 + i, 'a' + i));
+    }
+    m.payload = std::vector<uint8_t>(n * 10, 1);
+    m.note = std::make_unique<std::string>(n * 10, 'n');
+    m.tag = std::string(n * 10, 't');
+    return m;
+  };
+  auto first = encode(make(3)).value();
+  auto second = encode(make(2)).value();
+
+  Message message;
+  ScaleDecoderStream s(first);
+  s.setReusingStorage(true);
+  ASSERT_TRUE(s.isReusingStorage());
+  s >> message;
+  const auto *name = message.names[0].data();
+  const auto *payload = message.payload->data();
+  const auto *note = message.note.get();
+  const auto *tag = std::get<std::string>(message.tag).data();
+
+  ScaleDecoderStream t(second);
+  t.setReusingStorage(true);
+  t >> message;
+  ASSERT_EQ(encode(message).value(), second);
+  ASSERT_EQ(message.names[0].data(), name);
+  ASSERT_EQ(message.payload->data(), payload);
+  ASSERT_EQ(message.note.get(), note);
+  ASSERT_EQ(std::get<std::string>(message.tag).data(), tag);
+}
+
 struct ExplicitlyDefinedAsDynamic : public std::vector<int> {
   using Collection = std::vector<int>;
   using Collection::Collection;
@@ -0,0 +1,135 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+#include <scale/scale.hpp>
+
+using scale::ByteArray;
+using scale::Columns;
+using scale::decode;
+using scale::encode;
+
+/// Record of fixed width, with padding in memory, but not in encoding
+struct Transfer {
+  uint8_t kind;
+  uint64_t amount;
+  std::array<uint8_t, 4> account;
+
+  bool operator==(const Transfer &) const = default;
+};
+
+/// Record of variable width
+struct Event {
+  uint32_t index;
+  bool success;
+  std::vector<uint8_t> data;
+
+  bool operator==(const Event &) const = default;
+};
+
+static_assert(Columns<Transfer>::kFixedWidth);
+static_assert(Columns<Transfer>::kRecordSize == 13);
+static_assert(not Columns<Event>::kFixedWidth);
+
+/**
+ * @given vector of fixed width records
+ * @when it is decoded to columns and encoded back
+ * @then each field is in its own column, encoding is identical
+ */
+TEST(Columns, FixedWidthRoundTrip) {
+  std::vector<Transfer> transfers{
+      {1, 1000, {1, 2, 3, 4}},
+      {2, 0xFFFFFFFFFFFFull, {5, 6, 7, 8}},
+      {3, 42, {9, 10, 11, 12}},
+  };
+  auto encoded = encode(transfers).value();
+  auto columns = decode<Columns<Transfer>>(encoded).value();
+
+  ASSERT_EQ(columns.size(), transfers.size());
+  ASSERT_EQ(columns.column<0>(), (std::vector<uint8_t>{1, 2, 3}));
+  ASSERT_EQ(columns.column<1>(),
+            (std::vector<uint64_t>{1000, 0xFFFFFFFFFFFFull, 42}));
+  for (size_t i = 0; i < transfers.size(); ++i) {
+    ASSERT_EQ(columns[i], transfers[i]);
+  }
+  ASSERT_EQ(encode(columns).value(), encoded);
+
+  encoded.pop_back();
+  ASSERT_OUTCOME_ERROR(decode<Columns<Transfer>>(encoded),
+                       scale::DecodeError::NOT_ENOUGH_DATA);
+}
+
+/**
+ * @given vector of records of variable width
+ * @when it is decoded to columns and encoded back
+ * @then records are restored, encoding is identical
+ */
+TEST(Columns, VariableWidthRoundTrip) {
+  std::vector<Event> events{
+      {7, true, {1, 2}},
+      {8, false, {}},
+  };
+  auto encoded = encode(events).value();
+  auto columns = decode<Columns<Event>>(encoded).value();
+
+  ASSERT_EQ(columns.column<1>(), (std::vector<bool>{true, false}));
+  ASSERT_EQ(columns[0], events[0]);
+  ASSERT_EQ(columns[1], events[1]);
+  ASSERT_EQ(encode(columns).value(), encoded);
+
+  Columns<Event> built;
+  for (auto &event : events) {
+    built.push_back(event);
+  }
+  ASSERT_EQ(built, columns);
+}
+
+/**
+ * @given equally sized columns of fixed width, more than fit in one chunk
+ * @when view over them is encoded
+ * @then encoding is the same as of vector of tuples of the same fields
+ */
+TEST(Columns, ViewOfFixedWidthColumns) {
+  std::vector<uint64_t> nonces;
+  std::vector<uint16_t> tips;
+  std::vector<std::array<uint8_t, 4>> senders;
+  std::vector<std::tuple<uint64_t, uint16_t, std::array<uint8_t, 4>>> rows;
+  for (uint8_t i = 0; i < 250; ++i) {
+    nonces.push_back(i * 1000003ull);
+    tips.push_back(i * 7);
+    senders.push_back({i, 1, 2, 3});
+    rows.emplace_back(nonces.back(), tips.back(), senders.back());
+  }
+  scale::ColumnsView view(nonces, tips, senders);
+  static_assert(decltype(view)::kFixedWidth);
+  ASSERT_EQ(encode(view).value(), encode(rows).value());
+
+  scale::ScaleEncoderStream counter(true);
+  counter << view;
+  ASSERT_EQ(counter.size(), encode(rows).value().size());
+
+  tips.pop_back();
+  ASSERT_OUTCOME_ERROR(encode(scale::ColumnsView(nonces, tips, senders)),
+                       scale::EncodeError::INCONSISTENT_COLUMN_SIZES);
+}
+
+/**
+ * @given columns of variable width
+ * @when view over them is encoded
+ * @then encoding is the same as of vector of aggregates of the same fields
+ */
+TEST(Columns, ViewOfVariableWidthColumns) {
+  std::vector<uint32_t> indices{7, 8};
+  std::vector<std::string> names{"a", "bc"};
+  struct Named {
+    uint32_t index;
+    std::string name;
+  };
+  std::vector<Named> records{{7, "a"}, {8, "bc"}};
+  ASSERT_EQ(encode(scale::ColumnsView(indices, names)).value(),
+            encode(records).value());
+}
@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <random>
+
 #include <gtest/gtest.h>
 #include <qtils/test/outcome.hpp>
+#include <scale/detail/jam_compact_integer.hpp>
 #include <scale/scale.hpp>
 
 using scale::ByteArray;
@@ -205,3 +208,310 @@ INSTANTIATE_TEST_SUITE_P(
 
 #endif
 
+
+#ifndef JAM_COMPATIBILITY_ENABLED
+
+/**
+ * @given big-mode compact encodings of values fitting native integers
+ * @when decode them to native and multiprecision compact targets
+ * @then decoded values match original ones
+ */
+TEST(ScaleCompactTest, DecodeBigModeToNativeTarget) {
+  ByteArray bytes{0b0000'0111, 0x01, 0x00, 0x00, 0x00, 0b0000'1000};
+  ASSERT_OUTCOME_SUCCESS(as_u64, decode<scale::Compact<uint64_t>>(bytes));
+  ASSERT_EQ(untagged(as_u64), (1ull << 35) + 1);
+  ASSERT_OUTCOME_SUCCESS(as_u128,
+                         decode<scale::Compact<scale::uint128_t>>(bytes));
+  ASSERT_EQ(untagged(as_u128), (1ull << 35) + 1);
+
+  ByteArray max_u64(9, 0xFF);
+  max_u64[0] = 0b0001'0011;
+  ASSERT_OUTCOME_SUCCESS(max, decode<scale::Compact<uint64_t>>(max_u64));
+  ASSERT_EQ(untagged(max), std::numeric_limits<uint64_t>::max());
+}
+
+/**
+ * @given compact encodings of values exceeding range of target type
+ * @when decode them
+ * @then DECODED_VALUE_OVERFLOWS_TARGET error is returned
+ */
+TEST(ScaleCompactTest, DecodeToNarrowTargetFails) {
+  ByteArray five_bytes{0b0000'0111, 0x01, 0x00, 0x00, 0x00, 0b0000'1000};
+  ASSERT_OUTCOME_ERROR(decode<scale::Compact<uint32_t>>(five_bytes),
+                       scale::DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+
+  ByteArray ten_bytes(11, 0x01);
+  ten_bytes[0] = 0b0001'1011;
+  ASSERT_OUTCOME_ERROR(decode<scale::Compact<uint64_t>>(ten_bytes),
+                       scale::DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+
+  ByteArray two_bytes{253, 7};  // 511
+  ASSERT_OUTCOME_ERROR(decode<scale::Compact<uint8_t>>(two_bytes),
+                       scale::DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+}
+
+/**
+ * @given values of each compact mode boundary
+ * @when encode them as native and multiprecision compact integers
+ * @then encodings are equal and their size is predicted by
+ * lengthOfEncodedCompactInteger
+ */
+TEST(ScaleCompactTest, NativeEncodingMatchesMultiprecision) {
+  const std::vector<uint64_t> values{0,
+                                     63,
+                                     64,
+                                     16383,
+                                     16384,
+                                     (1ull << 30) - 1,
+                                     1ull << 30,
+                                     (1ull << 32) - 1,
+                                     1ull << 35,
+                                     (1ull << 56) + 1,
+                                     std::numeric_limits<uint64_t>::max()};
+  for (auto value : values) {
+    ASSERT_OUTCOME_SUCCESS(native, encode(scale::Compact<uint64_t>(value)));
+    ASSERT_OUTCOME_SUCCESS(big, encode(Compact(value)));
+    ASSERT_EQ(native, big) << value;
+    ASSERT_EQ(native.size(),
+              scale::detail::lengthOfEncodedCompactInteger(value))
+        << value;
+    ASSERT_EQ(native.size(),
+              scale::detail::lengthOfEncodedCompactInteger(
+                  boost::multiprecision::uint1024_t(value)))
+        << value;
+  }
+}
+
+#endif
+
+/// Previous loop-based jam-compact encoder, used as a reference
+void referenceEncodeJamCompact(uint64_t value, ScaleEncoderStream &stream) {
+  if (value < 0x80) {
+    stream << static_cast<uint8_t>(value);
+    return;
+  }
+  std::array<uint8_t, sizeof(uint64_t) + 1> bytes;
+  uint8_t &prefix = bytes[0] = 0;
+  size_t len = 1;
+  for (auto i = value; i != 0; i >>= 8) {
+    if (i <= (static_cast<uint8_t>(~prefix) >> 1)) {
+      prefix |= i;
+      break;
+    }
+    prefix = (prefix >> 1) | 0x80;
+    bytes[len++] = static_cast<uint8_t>(i & 0xff);
+  }
+  for (auto byte : bytes) {
+    stream << byte;
+    if (--len == 0) break;
+  }
+}
+
+/// Previous loop-based jam-compact decoder, used as a reference
+uint64_t referenceDecodeJamCompact(ScaleDecoderStream &stream) {
+  uint8_t byte;
+  stream >> byte;
+  if (byte == 0) {
+    return 0;
+  }
+  uint8_t len_bits = byte;
+  uint8_t val_bits = byte;
+  uint8_t val_mask = 0xff;
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < 8; ++i) {
+    val_mask >>= 1;
+    val_bits &= val_mask;
+    if ((len_bits & static_cast<uint8_t>(0x80)) == 0) {
+      value |= static_cast<uint64_t>(val_bits) << (8 * i);
+      break;
+    }
+    len_bits <<= 1;
+    stream >> byte;
+    value |= static_cast<uint64_t>(byte) << (8 * i);
+  }
+  if (val_bits == 0 and (byte & ~val_mask) == 0) {
+    raise(scale::DecodeError::REDUNDANT_COMPACT_ENCODING);
+  }
+  return value;
+}
+
+/**
+ * @given random values of random bit width
+ * @when encode and decode them as jam-compact integers
+ * @then result is the same as of the previous implementation
+ */
+TEST(ScaleCompactTest, JamCompactMatchesReferenceImplementation) {
+  std::mt19937_64 rand(42);
+  for (size_t i = 0; i < 100'000; ++i) {
+    const uint64_t value = rand() >> (rand() % 64);
+
+    ScaleEncoderStream actual;
+    scale::detail::encodeJamCompactInteger(value, actual);
+    ScaleEncoderStream expected;
+    referenceEncodeJamCompact(value, expected);
+    ASSERT_EQ(actual.to_vector(), expected.to_vector()) << value;
+    ASSERT_EQ(actual.size(),
+              scale::detail::lengthOfEncodedJamCompactInteger(value));
+
+    auto bytes = actual.to_vector();
+    ScaleDecoderStream stream(bytes);
+    ASSERT_EQ(scale::detail::decodeJamCompactInteger(stream), value);
+    ASSERT_FALSE(stream.hasMore(1));
+  }
+}
+
+/**
+ * @given random byte sequences
+ * @when decode them as jam-compact integers
+ * @then each accepted value is accepted by previous implementation too, and
+ * values accepted by previous implementation only are not canonical
+ */
+TEST(ScaleCompactTest, JamCompactDecodesRandomBytesAsReference) {
+  std::mt19937_64 rand(42);
+  for (size_t i = 0; i < 100'000; ++i) {
+    ByteArray bytes(1 + rand() % 10);
+    for (auto &byte : bytes) {
+      byte = rand() >> (rand() % 2 == 0 ? 56 : 60);
+    }
+    bytes[0] |= rand() % 2 == 0 ? 0 : 0xff << (rand() % 9);
+
+    std::optional<uint64_t> actual, expected;
+    ScaleDecoderStream actual_stream(bytes), expected_stream(bytes);
+    try {
+      actual = scale::detail::decodeJamCompactInteger(actual_stream);
+    } catch (const std::system_error &) {
+    }
+    try {
+      expected = referenceDecodeJamCompact(expected_stream);
+    } catch (const std::system_error &) {
+    }
+
+    if (actual.has_value()) {
+      ASSERT_EQ(actual, expected);
+      ASSERT_EQ(actual_stream.currentIndex(), expected_stream.currentIndex());
+    } else if (expected.has_value()) {
+      // previous implementation accepted some redundant encodings
+      ASSERT_LT(scale::detail::lengthOfEncodedJamCompactInteger(*expected),
+                expected_stream.currentIndex());
+    }
+  }
+}
+
+/**
+ * @given vectors of native compact integers with runs of single-byte items
+ * of various lengths interleaved with multibyte items
+ * @when encode and decode them
+ * @then decoded vectors are equal to original ones
+ */
+TEST(ScaleCompactTest, DecodeVectorOfNativeCompacts) {
+  std::mt19937_64 rand(42);
+  for (size_t run : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+    // runs of multibyte items make decoder stop and resume vectorized scan
+    for (size_t multi : {1, 2, 20}) {
+      std::vector<scale::Compact<uint64_t>> original;
+      for (size_t i = 0; i < 10; ++i) {
+        for (size_t k = 0; k < run; ++k) {
+          original.emplace_back(rand() % 64);
+        }
+        for (size_t k = 0; k < multi; ++k) {
+          original.emplace_back(128 + (rand() >> (1 + rand() % 63)));
+        }
+      }
+      ASSERT_OUTCOME_SUCCESS(encoded, encode(original));
+
+      ASSERT_OUTCOME_SUCCESS(
+          decoded, decode<std::vector<scale::Compact<uint64_t>>>(encoded));
+      ASSERT_EQ(decoded.size(), original.size());
+      for (size_t i = 0; i < original.size(); ++i) {
+        ASSERT_EQ(untagged(decoded[i]), untagged(original[i])) << i;
+      }
+    }
+  }
+}
+
+/**
+ * @given encoded vector of compact integers truncated or overflowing target
+ * @when decode it
+ * @then corresponding error is returned
+ */
+TEST(ScaleCompactTest, DecodeVectorOfNativeCompactsFails) {
+  std::vector<scale::Compact<uint32_t>> original(40, 1u);
+  original.emplace_back(1000);
+  ASSERT_OUTCOME_SUCCESS(encoded, encode(original));
+
+  auto truncated = ByteArray(encoded.begin(), encoded.end() - 1);
+  ASSERT_OUTCOME_ERROR(decode<std::vector<scale::Compact<uint32_t>>>(truncated),
+                       scale::DecodeError::NOT_ENOUGH_DATA);
+
+  ASSERT_OUTCOME_ERROR(decode<std::vector<scale::Compact<uint8_t>>>(encoded),
+                       scale::DecodeError::DECODED_VALUE_OVERFLOWS_TARGET);
+}
+
+/**
+ * @given native integers of various compact modes
+ * @when encode them as vector of compacts, as compact range, and item by item
+ * @then all encodings are the same, and are decoded back
+ */
+TEST(ScaleCompactTest, EncodeVectorOfNativeCompacts) {
+  std::mt19937_64 rand(42);
+  // encoded items take several chunks of encoder
+  std::vector<uint64_t> values(5000);
+  for (auto &value : values) {
+    value = rand() >> (rand() % 64);
+  }
+  std::vector<scale::Compact<uint64_t>> compacts(values.begin(), values.end());
+
+  ScaleEncoderStream expected;
+  expected << scale::Length(values.size());
+  for (auto value : values) {
+    expected << scale::Compact<uint64_t>(value);
+  }
+
+  ASSERT_OUTCOME_SUCCESS(as_vector, encode(compacts));
+  ASSERT_EQ(as_vector, expected.to_vector());
+  ASSERT_OUTCOME_SUCCESS(as_range, encode(scale::as_compact_range(values)));
+  ASSERT_EQ(as_range, expected.to_vector());
+
+  ScaleEncoderStream counter(true);
+  counter << scale::as_compact_range(values);
+  ASSERT_EQ(counter.size(), expected.size());
+
+  ASSERT_OUTCOME_SUCCESS(
+      decoded, decode<std::vector<scale::Compact<uint64_t>>>(as_range));
+  ASSERT_TRUE(std::ranges::equal(decoded, values, {}, [](auto &item) {
+    return untagged(item);
+  }));
+}
+
+/**
+ * @given streams of both compact integer codecs in the same build
+ * @when the same compact integers are encoded and decoded by each of them
+ * @then each stream uses its own codec regardless of default one
+ */
+TEST(ScaleCompactTest, CodecIsChosenPerStream) {
+  using scale::BasicScaleEncoderStream;
+  using scale::JamCompactCodec;
+  using scale::ScaleCompactCodec;
+  const std::vector<scale::Compact<uint32_t>> values{1, 300};
+
+  BasicScaleEncoderStream<ScaleCompactCodec> scale_encoder;
+  scale_encoder << scale::Compact<uint32_t>(300) << values;
+  ASSERT_EQ(scale_encoder.to_vector(),
+            (ByteArray{0xB1, 0x04, 0x08, 0x04, 0xB1, 0x04}));
+
+  BasicScaleEncoderStream<JamCompactCodec> jam_encoder;
+  jam_encoder << scale::Compact<uint32_t>(300) << values;
+  ASSERT_EQ(jam_encoder.to_vector(),
+            (ByteArray{0x81, 0x2C, 0x02, 0x01, 0x81, 0x2C}));
+
+  ASSERT_OUTCOME_SUCCESS(
+      from_scale,
+      (decode<std::vector<scale::Compact<uint32_t>>, ScaleCompactCodec>(
+          ByteArray{0x08, 0x04, 0xB1, 0x04})));
+  ASSERT_EQ(from_scale, values);
+  ASSERT_OUTCOME_SUCCESS(
+      from_jam,
+      (decode<std::vector<scale::Compact<uint32_t>>, JamCompactCodec>(
+          ByteArray{0x02, 0x01, 0x81, 0x2C})));
+  ASSERT_EQ(from_jam, values);
+}
@@ -4,6 +4,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <variant>
+
+#include <boost/variant.hpp>
 #include <gtest/gtest.h>
 #include <qtils/test/outcome.hpp>
 #include <scale/scale.hpp>
@@ -64,3 +72,92 @@ TEST(CustomDecomposable, decode) {
     EXPECT_EQ(expected, actual);
   }
 }
+
+struct ConstFields {
+  const uint32_t id;
+  const std::string name;
+
+  bool operator==(const ConstFields &other) const = default;
+};
+
+class Range {
+ public:
+  Range(uint32_t begin, uint32_t end) : begin_(begin), end_(end) {
+    if (begin > end) {
+      throw std::invalid_argument("begin of range is after end");
+    }
+  }
+
+  uint32_t size() const {
+    return end_ - begin_;
+  }
+
+  bool operator==(const Range &other) const = default;
+
+ private:
+  uint32_t begin_;
+  uint32_t end_;
+
+  SCALE_CUSTOM_DECOMPOSITION(Range, begin_, end_);
+};
+
+/**
+ * @given encoded values of types, which are not default constructible
+ * @when they are decoded standalone and inside optional, pointers, variant
+ * and containers
+ * @then they are constructed from their decoded fields
+ */
+TEST(CustomDecomposable, decodeNotDefaultConstructible) {
+  static_assert(not std::is_default_constructible_v<ConstFields>);
+  static_assert(not std::is_default_constructible_v<Range>);
+
+  ConstFields fields{7, "seven"};
+  ASSERT_OUTCOME_SUCCESS(decoded_fields,
+                         decode<ConstFields>(encode(fields).value()));
+  EXPECT_EQ(decoded_fields, fields);
+
+  Range range(3, 10);
+  auto encoded = encode(range).value();
+  ASSERT_OUTCOME_SUCCESS(decoded_range, decode<Range>(encoded));
+  EXPECT_EQ(decoded_range.size(), 7);
+
+  std::vector<Range> ranges{{1, 2}, {3, 5}};
+  ASSERT_OUTCOME_SUCCESS(decoded_ranges,
+                         decode<std::vector<Range>>(encode(ranges).value()));
+  EXPECT_EQ(decoded_ranges, ranges);
+
+  auto optional = decode<std::optional<Range>>(
+      encode(std::optional<Range>{range}).value());
+  EXPECT_EQ(optional.value(), range);
+
+  auto pointer = decode<std::unique_ptr<ConstFields>>(
+      encode(std::make_unique<ConstFields>(fields)).value());
+  EXPECT_EQ(*pointer.value(), fields);
+
+  using Variant = std::variant<uint8_t, Range>;
+  auto variant = decode<Variant>(encode(Variant{range}).value());
+  EXPECT_EQ(variant.value(), Variant{range});
+
+  using BoostVariant = boost::variant<uint8_t, Range>;
+  auto boost_variant =
+      decode<BoostVariant>(encode(BoostVariant{range}).value());
+  EXPECT_EQ(boost::get<Range>(boost_variant.value()), range);
+
+  std::tuple<uint8_t, Range> tuple{0, {0, 0}};
+  auto encoded_tuple = encode(std::tuple{uint8_t{1}, range}).value();
+  scale::ScaleDecoderStream s(encoded_tuple);
+  s >> tuple;
+  EXPECT_EQ(tuple, (std::tuple<uint8_t, Range>{1, range}));
+
+  std::map<uint32_t, Range> map{{1, range}};
+  auto decoded_map = decode<std::map<uint32_t, Range>>(encode(map).value());
+  EXPECT_EQ(decoded_map.value(), map);
+
+  auto pair = decode<std::pair<Range, uint8_t>>(
+      encode(std::pair<Range, uint8_t>{range, 1}).value());
+  EXPECT_EQ(pair.value().first, range);
+
+  // invariant established by constructor is checked
+  std::swap(encoded[0], encoded[4]);
+  EXPECT_THROW(std::ignore = decode<Range>(encoded), std::invalid_argument);
+}
@@ -3,7 +3,18 @@
  * All Rights Reserved
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <array>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
 #include <scale/scale.hpp>
 
 using scale::ByteArray;
@@ -54,3 +65,70 @@ TEST(ScaleDecoderStreamTest, HasMoreTest) {
 
   ASSERT_ANY_THROW(stream.nextByte());
 }
+
+struct ArenaEntry {
+  uint32_t id;
+  std::pmr::string name;
+
+  bool operator==(const ArenaEntry &) const = default;
+};
+
+struct ArenaBlock {
+  std::pmr::vector<std::pmr::string> names;
+  std::pmr::vector<ArenaEntry> entries;
+  std::pmr::map<uint32_t, std::pmr::string> index;
+  std::optional<std::pmr::string> extra;
+  std::shared_ptr<std::pmr::string> note;
+  std::vector<std::pmr::string> plain_names;
+  std::vector<std::optional<std::pmr::string>> maybe_names;
+  std::list<std::pmr::vector<uint32_t>> lists;
+};
+
+/**
+ * @given encoded block of pmr containers, strings and shared string
+ * @when it is decoded with monotonic memory resource set to stream, while
+ * default memory resource can not allocate
+ * @then block is decoded and all its memory is taken from the resource
+ */
+TEST(ScaleDecoderStreamTest, DecodeByMemoryResource) {
+  std::pmr::string name(40, 'n');
+  ArenaBlock block{
+      .names = {name, name},
+      .entries = {{1, name}, {2, name}},
+      .index = {{3, name}},
+      .extra = name,
+      .note = std::make_shared<std::pmr::string>(name),
+      .plain_names = {name, name},
+      .maybe_names = {name, std::nullopt},
+      .lists = {{1, 2, 3}, {4, 5}},
+  };
+  auto encoded = scale::encode(block).value();
+
+  std::array<std::byte, 8192> buffer{};
+  std::pmr::monotonic_buffer_resource arena(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  ScaleDecoderStream s(encoded);
+  s.setMemoryResource(&arena);
+  ASSERT_EQ(s.memoryResource(), &arena);
+
+  auto *previous =
+      std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  auto decoded = scale::decode<ArenaBlock>(s);
+  std::pmr::set_default_resource(previous);
+
+  ASSERT_OUTCOME_SUCCESS(value, std::move(decoded));
+  EXPECT_EQ(value.names, block.names);
+  EXPECT_EQ(value.entries, block.entries);
+  EXPECT_EQ(value.index, block.index);
+  EXPECT_EQ(value.extra, block.extra);
+  EXPECT_EQ(*value.note, *block.note);
+  EXPECT_EQ(value.names.get_allocator().resource(), &arena);
+  EXPECT_EQ(value.entries[1].name.get_allocator().resource(), &arena);
+  EXPECT_EQ(value.extra->get_allocator().resource(), &arena);
+  EXPECT_EQ(value.plain_names, block.plain_names);
+  EXPECT_EQ(value.maybe_names, block.maybe_names);
+  EXPECT_EQ(value.lists, block.lists);
+  EXPECT_EQ(value.plain_names[1].get_allocator().resource(), &arena);
+  EXPECT_EQ(value.maybe_names[0]->get_allocator().resource(), &arena);
+  EXPECT_EQ(value.lists.back().get_allocator().resource(), &arena);
+}
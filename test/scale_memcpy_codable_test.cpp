@@ -0,0 +1,304 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <deque>
+#include <list>
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+#include <scale/scale.hpp>
+
+using scale::ByteArray;
+using scale::decode;
+using scale::encode;
+using scale::MemcpyCodable;
+using scale::ScaleDecoderStream;
+using scale::ScaleEncoderStream;
+
+using Hash = std::array<uint8_t, 32>;
+
+/// Type which opts in to be memcpy-codable
+struct Weight {
+  uint64_t value;
+
+  bool operator==(const Weight &) const = default;
+};
+
+template <>
+struct scale::is_memcpy_codable<Weight> : std::true_type {};
+
+static_assert(MemcpyCodable<uint8_t>);
+static_assert(MemcpyCodable<uint32_t>);
+static_assert(MemcpyCodable<int64_t>);
+static_assert(MemcpyCodable<Hash>);
+static_assert(MemcpyCodable<std::array<uint16_t, 3>>);
+static_assert(MemcpyCodable<uint16_t[3]>);
+static_assert(MemcpyCodable<Weight>);
+static_assert(not MemcpyCodable<bool>);
+static_assert(not MemcpyCodable<std::array<bool, 4>>);
+static_assert(not MemcpyCodable<scale::Compact<uint32_t>>);
+static_assert(not MemcpyCodable<std::vector<uint8_t>>);
+
+/// Aggregate without padding
+struct Record {
+  uint32_t index;
+  uint32_t era;
+  uint64_t nonce;
+  Hash hash;
+
+  bool operator==(const Record &) const = default;
+};
+
+/// Aggregate of aggregate without padding
+struct Header {
+  Hash parent;
+  Record record;
+
+  bool operator==(const Header &) const = default;
+};
+
+/// Aggregate with padding after the first field
+struct PaddedRecord {
+  uint32_t index;
+  uint64_t nonce;
+  Hash hash;
+
+  bool operator==(const PaddedRecord &) const = default;
+};
+
+/// Aggregate with field which is not memcpy-codable
+struct FlaggedRecord {
+  uint32_t index;
+  bool flag;
+  std::array<uint8_t, 3> tail;
+
+  bool operator==(const FlaggedRecord &) const = default;
+};
+
+/// Padding-free aggregate, which encodes itself as compact integer
+struct Timestamp {
+  uint64_t value;
+
+  bool operator==(const Timestamp &) const = default;
+
+  friend ScaleEncoderStream &operator<<(ScaleEncoderStream &s,
+                                        const Timestamp &v) {
+    return s << scale::as_compact(v.value);
+  }
+
+  friend ScaleDecoderStream &operator>>(ScaleDecoderStream &s, Timestamp &v) {
+    return s >> scale::as_compact(v.value);
+  }
+};
+
+static_assert(MemcpyCodable<Record>);
+static_assert(not MemcpyCodable<Timestamp>);
+static_assert(MemcpyCodable<Header>);
+static_assert(not MemcpyCodable<PaddedRecord>);
+static_assert(not MemcpyCodable<FlaggedRecord>);
+
+/**
+ * Encodes collection item by item, as it is done for not memcpy-codable items
+ */
+template <typename T>
+ByteArray encodeItemwise(const std::vector<T> &collection) {
+  ScaleEncoderStream s;
+  s << scale::Length(collection.size());
+  for (const auto &item : collection) {
+    if constexpr (std::is_same_v<T, Weight>) {
+      s << item.value;
+    } else {
+      s << item;
+    }
+  }
+  return s.to_vector();
+}
+
+/**
+ * @given vectors of memcpy-codable items
+ * @when encode them and decode back
+ * @then encoding is the same as item-by-item one, and decoded are equal
+ */
+TEST(MemcpyCodable, VectorRoundTrip) {
+  std::vector<uint32_t> numbers{0, 1, 0x12345678, 0xFFFFFFFF};
+  ASSERT_OUTCOME_SUCCESS(encoded_numbers, encode(numbers));
+  ASSERT_EQ(encoded_numbers, encodeItemwise(numbers));
+  ASSERT_OUTCOME_SUCCESS(decoded_numbers,
+                         decode<std::vector<uint32_t>>(encoded_numbers));
+  ASSERT_EQ(decoded_numbers, numbers);
+
+  std::vector<Hash> hashes(3);
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    std::ranges::fill(hashes[i], i + 1);
+  }
+  ASSERT_OUTCOME_SUCCESS(encoded_hashes, encode(hashes));
+  ASSERT_EQ(encoded_hashes, encodeItemwise(hashes));
+  ASSERT_OUTCOME_SUCCESS(decoded_hashes,
+                         decode<std::vector<Hash>>(encoded_hashes));
+  ASSERT_EQ(decoded_hashes, hashes);
+
+  std::vector<Weight> weights{{1}, {0x0102030405060708}};
+  ASSERT_OUTCOME_SUCCESS(encoded_weights, encode(weights));
+  ASSERT_EQ(encoded_weights, encodeItemwise(weights));
+  ASSERT_OUTCOME_SUCCESS(decoded_weights,
+                         decode<std::vector<Weight>>(encoded_weights));
+  ASSERT_EQ(decoded_weights, weights);
+}
+
+/**
+ * @given encoded vector of integers
+ * @when decode it to not contiguous collections
+ * @then they are decoded item by item the same way
+ */
+TEST(MemcpyCodable, NotContiguousCollection) {
+  std::vector<uint16_t> numbers{1, 2, 0xABCD};
+  ASSERT_OUTCOME_SUCCESS(encoded, encode(numbers));
+  ASSERT_OUTCOME_SUCCESS(as_deque, decode<std::deque<uint16_t>>(encoded));
+  ASSERT_TRUE(std::ranges::equal(as_deque, numbers));
+  ASSERT_OUTCOME_SUCCESS(as_list, decode<std::list<uint16_t>>(encoded));
+  ASSERT_TRUE(std::ranges::equal(as_list, numbers));
+}
+
+/**
+ * @given fixed-size arrays of memcpy-codable items
+ * @when encode them and decode back
+ * @then encoding has no length prefix, and decoded are equal
+ */
+TEST(MemcpyCodable, StaticCollectionRoundTrip) {
+  std::array<uint16_t, 3> array{1, 0x0203, 0xFFFF};
+  ASSERT_OUTCOME_SUCCESS(encoded, encode(array));
+  ASSERT_EQ(encoded, (ByteArray{1, 0, 3, 2, 0xFF, 0xFF}));
+  ASSERT_OUTCOME_SUCCESS(decoded, (decode<std::array<uint16_t, 3>>(encoded)));
+  ASSERT_EQ(decoded, array);
+
+  const uint32_t c_array[2] = {0x01020304, 5};
+  ScaleEncoderStream encoder;
+  encoder << c_array;
+  auto c_encoded = encoder.to_vector();
+  ASSERT_EQ(c_encoded, (ByteArray{4, 3, 2, 1, 5, 0, 0, 0}));
+  uint32_t c_decoded[2] = {};
+  ScaleDecoderStream decoder(c_encoded);
+  decoder >> c_decoded;
+  ASSERT_TRUE(std::ranges::equal(c_decoded, c_array));
+}
+
+/**
+ * @given truncated encodings of collections of memcpy-codable items
+ * @when decode them
+ * @then decoding fails with NOT_ENOUGH_DATA
+ */
+TEST(MemcpyCodable, NotEnoughData) {
+  // declared 3 items by 4 bytes, but 11 bytes are present
+  ByteArray vector_bytes{12, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  ASSERT_OUTCOME_ERROR(decode<std::vector<uint32_t>>(vector_bytes),
+                       scale::DecodeError::NOT_ENOUGH_DATA);
+
+  // declared huge amount of items
+  ByteArray huge_bytes{0xFE, 0xFF, 0xFF, 0xFF, 1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_OUTCOME_ERROR(decode<std::vector<uint64_t>>(huge_bytes),
+                       scale::DecodeError::NOT_ENOUGH_DATA);
+
+  ByteArray array_bytes{1, 2, 3};
+  ASSERT_OUTCOME_ERROR((decode<std::array<uint16_t, 2>>(array_bytes)),
+                       scale::DecodeError::NOT_ENOUGH_DATA);
+}
+
+/**
+ * Encodes aggregate field by field, as it is done for not memcpy-codable ones
+ */
+ByteArray encodeFieldwise(const Record &record) {
+  ScaleEncoderStream s;
+  s << record.index << record.era << record.nonce << record.hash;
+  return s.to_vector();
+}
+
+Record makeRecord(uint32_t seed) {
+  Record record{.index = seed, .era = seed * 3, .nonce = seed * 1000003ull};
+  std::ranges::fill(record.hash, static_cast<uint8_t>(seed));
+  return record;
+}
+
+/**
+ * @given padding-free aggregates and vectors of them
+ * @when encode them and decode back
+ * @then encoding is the same as field-by-field one, and decoded are equal
+ */
+TEST(MemcpyCodable, AggregateRoundTrip) {
+  auto record = makeRecord(7);
+  ASSERT_OUTCOME_SUCCESS(encoded, encode(record));
+  ASSERT_EQ(encoded, encodeFieldwise(record));
+  ASSERT_OUTCOME_SUCCESS(decoded, decode<Record>(encoded));
+  ASSERT_EQ(decoded, record);
+
+  Header header{.record = record};
+  std::ranges::fill(header.parent, 0xAA);
+  ASSERT_OUTCOME_SUCCESS(encoded_header, encode(header));
+  ByteArray expected_header(header.parent.begin(), header.parent.end());
+  expected_header.insert(expected_header.end(), encoded.begin(), encoded.end());
+  ASSERT_EQ(encoded_header, expected_header);
+  ASSERT_OUTCOME_SUCCESS(decoded_header, decode<Header>(encoded_header));
+  ASSERT_EQ(decoded_header, header);
+
+  std::vector<Record> records{makeRecord(1), makeRecord(2), makeRecord(3)};
+  ScaleEncoderStream expected;
+  expected << scale::Length(records.size());
+  for (auto &item : records) {
+    expected.putBytes(encodeFieldwise(item));
+  }
+  ASSERT_OUTCOME_SUCCESS(encoded_records, encode(records));
+  ASSERT_EQ(encoded_records, expected.to_vector());
+  ASSERT_OUTCOME_SUCCESS(decoded_records,
+                         decode<std::vector<Record>>(encoded_records));
+  ASSERT_EQ(decoded_records, records);
+}
+
+/**
+ * @given aggregates with padding or with not memcpy-codable field
+ * @when encode them and decode back
+ * @then they are encoded field by field, and decoded are equal
+ */
+TEST(MemcpyCodable, AggregateFallback) {
+  PaddedRecord padded{.index = 1, .nonce = 2};
+  std::ranges::fill(padded.hash, 3);
+  ASSERT_OUTCOME_SUCCESS(encoded_padded, encode(padded));
+  ASSERT_EQ(encoded_padded.size(), 4 + 8 + 32);
+  ASSERT_OUTCOME_SUCCESS(decoded_padded, decode<PaddedRecord>(encoded_padded));
+  ASSERT_EQ(decoded_padded, padded);
+
+  FlaggedRecord flagged{.index = 1, .flag = true, .tail = {4, 5, 6}};
+  ASSERT_OUTCOME_SUCCESS(encoded_flagged, encode(flagged));
+  ASSERT_EQ(encoded_flagged, (ByteArray{1, 0, 0, 0, 1, 4, 5, 6}));
+  ASSERT_OUTCOME_SUCCESS(decoded_flagged,
+                         decode<FlaggedRecord>(encoded_flagged));
+  ASSERT_EQ(decoded_flagged, flagged);
+
+  encoded_flagged[4] = 2;
+  ASSERT_OUTCOME_ERROR(decode<FlaggedRecord>(encoded_flagged),
+                       scale::DecodeError::UNEXPECTED_VALUE);
+}
+
+/**
+ * @given vector of padding-free aggregates with own codec
+ * @when encode it and decode back
+ * @then items are encoded by own codec, not copied as memory
+ */
+TEST(MemcpyCodable, AggregateWithCustomCodec) {
+  std::vector<Timestamp> timestamps{{1}, {64}, {1ull << 40}};
+  ASSERT_OUTCOME_SUCCESS(encoded, encode(timestamps));
+  ScaleEncoderStream expected;
+  expected << scale::Length(timestamps.size());
+  for (auto &item : timestamps) {
+    expected << scale::as_compact(item.value);
+  }
+  ASSERT_EQ(encoded, expected.to_vector());
+
+  std::array<Timestamp, 2> pair{{{2}, {3}}};
+  ASSERT_OUTCOME_SUCCESS(encoded_pair, encode(pair));
+  ASSERT_EQ(encoded_pair, (ByteArray{2 << 2, 3 << 2}));
+  ASSERT_OUTCOME_SUCCESS(decoded_pair,
+                         (decode<std::array<Timestamp, 2>>(encoded_pair)));
+  ASSERT_EQ(decoded_pair, pair);
+}
@@ -4,10 +4,15 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <random>
+
 #include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+#include <scale/detail/simd.hpp>
 #include <scale/scale.hpp>
 
 using scale::ByteArray;
+using scale::ValidatedUtf8String;
 using scale::ScaleDecoderStream;
 using scale::ScaleEncoderStream;
 
@@ -62,3 +67,170 @@ TEST(StringTest, StringDecodeSuccess) {
 
   ASSERT_TRUE(std::ranges::equal(i, o));
 }
+
+/**
+ * @given encoded string and byte vector of several megabytes
+ * @when they are decoded using ScaleDecoderStream
+ * @then decoded values match originals, and truncated data is rejected
+ */
+TEST(StringTest, LargeBytesDecodeSuccess) {
+  std::string str(3 << 20, '\0');
+  for (size_t i = 0; i < str.size(); ++i) {
+    str[i] = static_cast<char>(i * 31 + (i >> 11));
+  }
+  ByteArray blob(str.begin(), str.end());
+
+  ScaleEncoderStream es;
+  ASSERT_NO_THROW((es << str << blob));
+  auto encoded = es.to_vector();
+
+  ScaleDecoderStream ds(encoded);
+  std::string decoded_str = "previous content";
+  ByteArray decoded_blob(10, 0xFF);
+  ASSERT_NO_THROW((ds >> decoded_str >> decoded_blob));
+  ASSERT_EQ(decoded_str, str);
+  ASSERT_EQ(decoded_blob, blob);
+  ASSERT_FALSE(ds.hasMore(1));
+
+  encoded.pop_back();
+  ScaleDecoderStream truncated(encoded);
+  ASSERT_NO_THROW((truncated >> decoded_str));
+  EXPECT_THROW((truncated >> decoded_blob), std::system_error);
+}
+
+/**
+ * Straightforward UTF-8 validation by decoding of code points
+ */
+bool referenceIsValidUtf8(const std::string &str) {
+  static const uint32_t min_code_point[] = {0, 0x80, 0x800, 0x10000};
+  size_t i = 0;
+  while (i < str.size()) {
+    auto lead = static_cast<uint8_t>(str[i]);
+    size_t tail = 0;
+    uint32_t code_point = 0;
+    if (lead < 0x80) {
+      ++i;
+      continue;
+    } else if ((lead & 0xE0) == 0xC0) {
+      tail = 1;
+      code_point = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+      tail = 2;
+      code_point = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+      tail = 3;
+      code_point = lead & 0x07;
+    } else {
+      return false;
+    }
+    if (i + tail >= str.size()) {
+      return false;
+    }
+    for (size_t k = 1; k <= tail; ++k) {
+      auto byte = static_cast<uint8_t>(str[i + k]);
+      if ((byte & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (byte & 0x3F);
+    }
+    if (code_point < min_code_point[tail] or code_point > 0x10FFFF
+        or (code_point >= 0xD800 and code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += tail + 1;
+  }
+  return true;
+}
+
+void appendUtf8(std::string &str, uint32_t code_point) {
+  if (code_point < 0x80) {
+    str += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    str += static_cast<char>(0xC0 | (code_point >> 6));
+    str += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    str += static_cast<char>(0xE0 | (code_point >> 12));
+    str += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    str += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    str += static_cast<char>(0xF0 | (code_point >> 18));
+    str += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    str += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    str += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+/**
+ * @given encoded strings of valid and malformed UTF-8
+ * @when they are decoded as ValidatedUtf8String
+ * @then valid ones are decoded as is, and malformed ones are rejected
+ */
+TEST(StringTest, ValidatedUtf8StringDecode) {
+  auto decode = [](const std::string &str) {
+    return scale::decode<ValidatedUtf8String>(scale::encode(str).value());
+  };
+
+  for (std::string valid : {"", "abc", "\u00e9t\u00e9", "\u20ac\U0001F600",
+                            "\u007F\u0080\u07FF\u0800\uFFFF\U00010000"
+                            "\U0010FFFF"}) {
+    ASSERT_OUTCOME_SUCCESS(decoded, decode(valid));
+    ASSERT_EQ(decoded, valid);
+  }
+
+  for (std::string invalid : {"\x80",
+                              "\xC0\x80",
+                              "\xC1\xBF",
+                              "\xE0\x9F\xBF",
+                              "\xED\xA0\x80",
+                              "\xF0\x8F\xBF\xBF",
+                              "\xF4\x90\x80\x80",
+                              "\xF5\x80\x80\x80",
+                              "\xFF",
+                              "abc\xE2\x82",
+                              "\xE2\x82" "abc"}) {
+    ASSERT_OUTCOME_ERROR(decode(invalid), scale::DecodeError::INVALID_UTF8);
+  }
+}
+
+/**
+ * @given random strings of mostly valid UTF-8 with random damages
+ * @when they are validated by each implementation available on CPU and
+ * decoded as ValidatedUtf8String
+ * @then results match straightforward validation
+ */
+TEST(StringTest, ValidatedUtf8StringMatchesReference) {
+  std::mt19937 rand(42);
+  const uint32_t max_code_point[] = {0x7F, 0x7FF, 0xFFFF, 0x10FFFF};
+  for (size_t n = 0; n < 20000; ++n) {
+    std::string str;
+    auto length = rand() % 100;
+    while (str.size() < length) {
+      uint32_t code_point = rand() % (max_code_point[rand() % 4] + 1);
+      if (code_point >= 0xD800 and code_point <= 0xDFFF) {
+        continue;
+      }
+      appendUtf8(str, code_point);
+    }
+    if (not str.empty() and rand() % 2 == 0) {
+      str[rand() % str.size()] = static_cast<char>(rand());
+    }
+
+    auto valid = referenceIsValidUtf8(str);
+    auto *data = reinterpret_cast<const uint8_t *>(str.data());
+    for (auto &impl : scale::detail::isValidUtf8Impls()) {
+      ASSERT_EQ(impl.fn(data, str.size()), valid) << impl.isa << ' ' << n;
+    }
+
+    ScaleEncoderStream es;
+    es << str;
+    auto encoded = es.to_vector();
+    ScaleDecoderStream ds(encoded);
+    ValidatedUtf8String decoded;
+    if (valid) {
+      ASSERT_NO_THROW(ds >> decoded) << n;
+      ASSERT_EQ(decoded, str);
+    } else {
+      ASSERT_THROW(ds >> decoded, std::system_error) << n;
+    }
+  }
+}